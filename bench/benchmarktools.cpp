@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "benchmarktools.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <algorithm>
+#include <iostream>
+
+namespace Breeze
+{
+
+//________________________________________________________________
+bool BenchmarkTools::setUpEnvironment(const QTemporaryDir &configDir, const char *benchmarkName)
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    if (!configDir.isValid()) {
+        std::cerr << benchmarkName << ": could not create a temporary configuration directory" << std::endl;
+        return false;
+    }
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(configDir.path()));
+    return true;
+}
+
+//________________________________________________________________
+QJsonObject BenchmarkTools::summary(QList<qint64> durations)
+{
+    std::sort(durations.begin(), durations.end());
+
+    qint64 total = 0;
+    for (const qint64 duration : std::as_const(durations)) {
+        total += duration;
+    }
+
+    QJsonObject result;
+    result[QStringLiteral("iterations")] = durations.count();
+    if (durations.isEmpty()) {
+        return result;
+    }
+    result[QStringLiteral("totalUs")] = total / 1000.0;
+    result[QStringLiteral("meanUs")] = total / 1000.0 / durations.count();
+    result[QStringLiteral("medianUs")] = durations.at(durations.count() / 2) / 1000.0;
+    result[QStringLiteral("minUs")] = durations.first() / 1000.0;
+    result[QStringLiteral("maxUs")] = durations.last() / 1000.0;
+    return result;
+}
+
+//________________________________________________________________
+int BenchmarkTools::writeResults(const QJsonObject &results, const QString &outputFilePath)
+{
+    const QByteArray json = QJsonDocument(results).toJson();
+    if (outputFilePath.isEmpty()) {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+
+    QFile outputFile(outputFilePath);
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << qPrintable(QCoreApplication::applicationName()) << ": could not write " << qPrintable(outputFile.fileName()) << std::endl;
+        return 1;
+    }
+    outputFile.write(json);
+    return 0;
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+class QTemporaryDir;
+
+namespace Breeze
+{
+
+/**
+ * @brief Functions shared by the klassy-decoration-bench and klassy-style-bench benchmarking tools
+ *        Not part of any installed library; each benchmark compiles this in directly.
+ */
+class BenchmarkTools
+{
+public:
+    /**
+     * @brief Runs the benchmark headless and against a private configuration, so that the user's Klassy settings are neither read nor overwritten
+     *        Must be called before the QApplication is created
+     * @param configDir temporary directory to use as XDG_CONFIG_HOME, which must outlive the benchmark
+     * @param benchmarkName name of the benchmark, for the error message
+     * @return false, after printing an error, if the temporary directory could not be created
+     */
+    static bool setUpEnvironment(const QTemporaryDir &configDir, const char *benchmarkName);
+
+    //* summary of a set of durations in nanoseconds, in microseconds
+    static QJsonObject summary(QList<qint64> durations);
+
+    /**
+     * @brief Writes the results as JSON, once the QApplication has been created
+     * @param results the benchmark's results
+     * @param outputFilePath file to write to, or empty to write to stdout
+     * @return the exit code of the benchmark
+     */
+    static int writeResults(const QJsonObject &results, const QString &outputFilePath);
+};
+
+}
@@ -0,0 +1,308 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "decorationbenchmark.h"
+#include "benchmarktools.h"
+#include "breezebutton.h"
+#include "breezedecoration.h"
+#include "breezedecorationanimation.h"
+#include "breezesettings.h"
+#include "decorationbuttoncolors.h"
+#include "decorationcolors.h"
+#include "presetsmodel.h"
+
+#include <KDecoration2/DecorationButtonGroup>
+#include <KSharedConfig>
+
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QGuiApplication>
+#include <QHoverEvent>
+#include <QImage>
+#include <QJsonArray>
+#include <QPainter>
+
+namespace Breeze
+{
+
+//________________________________________________________________
+DecorationBenchmark::DecorationBenchmark(int iterations)
+    : m_iterations(qMax(1, iterations))
+    , m_settings(std::make_shared<KDecoration2::DecorationSettings>(&m_bridge))
+{
+}
+
+//________________________________________________________________
+DecorationBenchmark::~DecorationBenchmark() = default;
+
+//________________________________________________________________
+bool DecorationBenchmark::savePresetAsSettings(const QString &presetFilePath, QString &presetName)
+{
+    KConfig presetFile(presetFilePath, KConfig::SimpleConfig);
+    const QStringList presetNames = PresetsModel::readPresetsList(&presetFile);
+    if (presetNames.isEmpty()) {
+        return false;
+    }
+    presetName = presetNames.first();
+
+    KSharedConfig::Ptr config = KSharedConfig::openConfig(QStringLiteral("klassy/klassyrc"));
+    InternalSettings settings;
+    settings.load();
+    if (!PresetsModel::loadPresetAndSave(&settings, config.data(), &presetFile, presetName, false)) {
+        return false;
+    }
+    config->sync();
+    return true;
+}
+
+//________________________________________________________________
+QJsonObject DecorationBenchmark::time(const std::function<void()> &function, int iterations) const
+{
+    QList<qint64> durations;
+    durations.reserve(iterations);
+
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; i++) {
+        timer.start();
+        function();
+        durations.append(timer.nsecsElapsed());
+    }
+
+    return BenchmarkTools::summary(durations);
+}
+
+//________________________________________________________________
+std::unique_ptr<Decoration> DecorationBenchmark::createDecoration()
+{
+    const QVariantMap args{{QStringLiteral("bridge"), QVariant::fromValue(static_cast<KDecoration2::DecorationBridge *>(&m_bridge))}};
+    auto decoration = std::make_unique<Decoration>(nullptr, QVariantList{args});
+    decoration->setSettings(m_settings);
+    decoration->init();
+    return decoration;
+}
+
+//________________________________________________________________
+void DecorationBenchmark::paint(Decoration *decoration)
+{
+    QImage image(decoration->size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    decoration->paint(&painter, decoration->rect());
+}
+
+//________________________________________________________________
+QJsonObject DecorationBenchmark::runDecoration()
+{
+    QJsonObject result;
+
+    // a window map adopting the current decoration template, as is usual
+    result[QStringLiteral("create")] = time(
+        [this]() {
+            createDecoration();
+        },
+        m_iterations);
+
+    // a window map after the configuration files have changed, which reloads the shared configuration as every window map used to
+    result[QStringLiteral("createConfigurationChanged")] = time(
+        [this]() {
+            Decoration::invalidateDecorationTemplate();
+            createDecoration();
+        },
+        m_iterations);
+
+    std::unique_ptr<Decoration> decoration = createDecoration();
+    FakeDecoratedClient *client = m_bridge.lastCreatedClient();
+    QCoreApplication::processEvents(); // run the delayed button layout
+
+    client->setActive(true);
+    result[QStringLiteral("paintActive")] = time(
+        [this, &decoration]() {
+            paint(decoration.get());
+        },
+        m_iterations);
+
+    client->setActive(false);
+    decoration->activeStateChangeAnimation()->stop();
+    result[QStringLiteral("paintInactive")] = time(
+        [this, &decoration]() {
+            paint(decoration.get());
+        },
+        m_iterations);
+    client->setActive(true);
+    decoration->activeStateChangeAnimation()->stop();
+
+    result[QStringLiteral("updateShadow")] = time(
+        [&decoration]() {
+            decoration->updateShadow(true);
+        },
+        m_iterations);
+
+    result[QStringLiteral("updateShadowCached")] = time(
+        [&decoration]() {
+            decoration->updateShadow();
+        },
+        m_iterations);
+
+    result[QStringLiteral("updateButtonsGeometry")] = time(
+        [&decoration]() {
+            decoration->updateButtonsGeometry();
+        },
+        m_iterations);
+
+    // an interactive resize: alternate the width, as each widthChanged is handled as KWin would deliver it
+    int resizeStep = 0;
+    result[QStringLiteral("resizeWidth")] = time(
+        [client, &resizeStep]() {
+            client->setSize(QSize(800 + (resizeStep++ % 2), 600));
+        },
+        m_iterations);
+    client->setSize(QSize(800, 600));
+
+    result[QStringLiteral("reconfigureMain")] = time(
+        [&decoration]() {
+            decoration->reconfigureMain();
+        },
+        m_iterations);
+
+    result[QStringLiteral("hoverAnimations")] = runHoverAnimations(decoration.get());
+
+    return result;
+}
+
+//________________________________________________________________
+QJsonObject DecorationBenchmark::runHoverAnimations(Decoration *decoration)
+{
+    QList<Button *> buttons;
+    for (auto group : {decoration->leftButtons(), decoration->rightButtons()}) {
+        for (auto button : group->buttons()) {
+            if (button->isVisible() && button->isEnabled()) {
+                buttons.append(static_cast<Button *>(button));
+            }
+        }
+    }
+
+    QList<qint64> frameDurations;
+    QElapsedTimer timer;
+    int animations = 0;
+
+    const QPointF outside(-1, -1);
+    QPointF lastPosition = outside;
+
+    auto moveHoverTo = [decoration, &lastPosition](const QPointF &position) {
+        QHoverEvent event(QEvent::HoverMove, position, position, lastPosition);
+        QCoreApplication::sendEvent(decoration, &event);
+        lastPosition = position;
+    };
+
+    auto paintUntilAnimationsFinish = [this, decoration, &frameDurations, &timer]() {
+        // the animations are advanced by the shared scheduler's timer, so the frames are painted as the event loop runs it
+        QDeadlineTimer deadline(5000);
+        do {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 16);
+            timer.start();
+            paint(decoration);
+            frameDurations.append(timer.nsecsElapsed());
+        } while (DecorationAnimationScheduler::self()->runningAnimationCount() > 0 && !deadline.hasExpired());
+    };
+
+    // hover animations are bounded by their duration in wall time, so run fewer of them
+    const int iterations = qMin(m_iterations, 5);
+    for (int i = 0; i < iterations; i++) {
+        for (Button *button : std::as_const(buttons)) {
+            moveHoverTo(button->geometry().center());
+            paintUntilAnimationsFinish();
+            moveHoverTo(outside);
+            paintUntilAnimationsFinish();
+            animations += 2;
+        }
+    }
+
+    QJsonObject result = BenchmarkTools::summary(frameDurations);
+    result[QStringLiteral("animations")] = animations;
+    result[QStringLiteral("frames")] = frameDurations.count();
+    return result;
+}
+
+//________________________________________________________________
+QJsonObject DecorationBenchmark::runPaletteStateMatrix()
+{
+    QJsonObject result;
+
+    InternalSettingsPtr settings(new InternalSettings());
+    settings->load();
+    DecorationButtonPalette::decodeButtonOverrideColorSettings(settings);
+
+    const QPalette palette = QGuiApplication::palette();
+    const QColor titleBarTextActive = palette.color(QPalette::Active, QPalette::WindowText);
+    const QColor titleBarBaseActive = palette.color(QPalette::Active, QPalette::Window);
+    const QColor titleBarTextInactive = palette.color(QPalette::Inactive, QPalette::WindowText);
+    const QColor titleBarBaseInactive = palette.color(QPalette::Inactive, QPalette::Window);
+
+    result[QStringLiteral("generate")] = time(
+        [&]() {
+            DecorationColors decorationColors(false);
+            decorationColors.generateDecorationAndButtonColors(palette,
+                                                               settings,
+                                                               titleBarTextActive,
+                                                               titleBarBaseActive,
+                                                               titleBarTextInactive,
+                                                               titleBarBaseInactive);
+        },
+        m_iterations);
+
+    DecorationColors decorationColors(false);
+    decorationColors.generateDecorationAndButtonColors(palette, settings, titleBarTextActive, titleBarBaseActive, titleBarTextInactive, titleBarBaseInactive);
+
+    result[QStringLiteral("regenerateUnchanged")] = time(
+        [&]() {
+            decorationColors.generateDecorationAndButtonColors(palette,
+                                                               settings,
+                                                               titleBarTextActive,
+                                                               titleBarBaseActive,
+                                                               titleBarTextInactive,
+                                                               titleBarBaseInactive);
+        },
+        m_iterations);
+    result[QStringLiteral("regenerateUnchangedRecomputedEntries")] = decorationColors.lastRecomputedEntryCount();
+
+    // every button type x active/inactive x normal/hover/press x foreground/background/outline, at every animation step
+    int lookups = 0;
+    QRgb checksum = 0; // keeps the look-ups from being optimised away
+    result[QStringLiteral("stateMatrix")] = time(
+        [&]() {
+            for (const DecorationButtonType buttonType : coloredWindowDecorationButtonTypes) {
+                const DecorationButtonPalette *buttonPalette = decorationColors.buttonPalette(buttonType);
+                const DecorationButtonPaletteActiveStateTransitions *transitions = buttonPalette->activeStateTransitions();
+                for (const DecorationButtonPaletteGroup *group : {buttonPalette->active(), buttonPalette->inactive()}) {
+                    for (int step = 0; step <= ColorTransition::Steps; step++) {
+                        const qreal progress = qreal(step) / ColorTransition::Steps;
+                        for (const ColorTransition *transition : {&group->foregroundHoverTransition,
+                                                                  &group->backgroundHoverTransition,
+                                                                  &group->outlineHoverTransition,
+                                                                  &transitions->foregroundNormal,
+                                                                  &transitions->foregroundHover,
+                                                                  &transitions->foregroundPress,
+                                                                  &transitions->backgroundNormal,
+                                                                  &transitions->backgroundHover,
+                                                                  &transitions->backgroundPress,
+                                                                  &transitions->outlineNormal,
+                                                                  &transitions->outlineHover,
+                                                                  &transitions->outlinePress}) {
+                            checksum ^= transition->at(progress).rgba();
+                            lookups++;
+                        }
+                    }
+                }
+            }
+        },
+        m_iterations);
+    result[QStringLiteral("stateMatrixLookups")] = lookups / m_iterations;
+    result[QStringLiteral("stateMatrixChecksum")] = QString::number(checksum, 16);
+
+    return result;
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include "fakedecorationbridge.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QList>
+
+#include <functional>
+#include <memory>
+
+namespace Breeze
+{
+
+class Decoration;
+
+/**
+ * @brief Times the decoration's hot paths against a fake client, for whichever Klassy settings are currently saved in klassyrc
+ *        Results are returned as JSON objects so that they can be compared across commits
+ */
+class DecorationBenchmark
+{
+public:
+    //* @param iterations number of timed runs of each operation
+    explicit DecorationBenchmark(int iterations);
+    ~DecorationBenchmark();
+
+    /**
+     * @brief Saves the given bundled preset file into klassyrc, so that subsequent runs use it
+     * @param presetFilePath path to a .klpw preset file
+     * @param presetName returns the name of the preset contained in the file
+     * @return false if the file did not contain a preset
+     */
+    static bool savePresetAsSettings(const QString &presetFilePath, QString &presetName);
+
+    //* times creation, paint(), updateShadow(), updateButtonsGeometry(), reconfigureMain() and button hover animations of a new decoration
+    QJsonObject runDecoration();
+
+    //* times generation of the decoration and button palettes, and colour look-ups across every button type, active state, button state and animation step
+    QJsonObject runPaletteStateMatrix();
+
+private:
+    //* times \p iterations runs of \p function and returns a summary of the durations in microseconds
+    QJsonObject time(const std::function<void()> &function, int iterations) const;
+
+    //* new decoration attached to a fake client, initialised as KWin would
+    std::unique_ptr<Decoration> createDecoration();
+
+    //* paints the decoration with its buttons into an image the size of the decoration
+    void paint(Decoration *decoration);
+
+    //* hovers each visible button in turn and advances its hover animation to completion, timing each frame painted
+    QJsonObject runHoverAnimations(Decoration *decoration);
+
+    int m_iterations;
+    FakeDecorationBridge m_bridge;
+    std::shared_ptr<KDecoration2::DecorationSettings> m_settings;
+};
+
+}
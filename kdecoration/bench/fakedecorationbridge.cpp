@@ -0,0 +1,334 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "fakedecorationbridge.h"
+
+#include <QGuiApplication>
+
+namespace Breeze
+{
+
+//________________________________________________________________
+FakeDecoratedClient::FakeDecoratedClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration)
+    : KDecoration2::DecoratedClientPrivateV2(client, decoration)
+    , m_palette(QGuiApplication::palette())
+{
+}
+
+//________________________________________________________________
+void FakeDecoratedClient::setActive(bool active)
+{
+    if (m_active == active) {
+        return;
+    }
+    m_active = active;
+    Q_EMIT client()->activeChanged(active);
+}
+
+//________________________________________________________________
+void FakeDecoratedClient::setSize(const QSize &size)
+{
+    if (m_size == size) {
+        return;
+    }
+
+    const QSize oldSize = m_size;
+    m_size = size;
+    if (oldSize.width() != size.width()) {
+        Q_EMIT client()->widthChanged(size.width());
+    }
+    if (oldSize.height() != size.height()) {
+        Q_EMIT client()->heightChanged(size.height());
+    }
+    Q_EMIT client()->sizeChanged(size);
+}
+
+//________________________________________________________________
+void FakeDecoratedClient::setMaximized(bool maximized)
+{
+    if (m_maximized == maximized) {
+        return;
+    }
+    m_maximized = maximized;
+    Q_EMIT client()->maximizedHorizontallyChanged(maximized);
+    Q_EMIT client()->maximizedVerticallyChanged(maximized);
+    Q_EMIT client()->maximizedChanged(maximized);
+}
+
+bool FakeDecoratedClient::isActive() const
+{
+    return m_active;
+}
+
+QString FakeDecoratedClient::caption() const
+{
+    return QStringLiteral("Klassy Decoration Benchmark");
+}
+
+bool FakeDecoratedClient::isOnAllDesktops() const
+{
+    return false;
+}
+
+bool FakeDecoratedClient::isShaded() const
+{
+    return false;
+}
+
+QIcon FakeDecoratedClient::icon() const
+{
+    return QIcon::fromTheme(QStringLiteral("utilities-terminal"));
+}
+
+bool FakeDecoratedClient::isMaximized() const
+{
+    return m_maximized;
+}
+
+bool FakeDecoratedClient::isMaximizedHorizontally() const
+{
+    return m_maximized;
+}
+
+bool FakeDecoratedClient::isMaximizedVertically() const
+{
+    return m_maximized;
+}
+
+bool FakeDecoratedClient::isKeepAbove() const
+{
+    return false;
+}
+
+bool FakeDecoratedClient::isKeepBelow() const
+{
+    return false;
+}
+
+bool FakeDecoratedClient::isCloseable() const
+{
+    return true;
+}
+
+bool FakeDecoratedClient::isMaximizeable() const
+{
+    return true;
+}
+
+bool FakeDecoratedClient::isMinimizeable() const
+{
+    return true;
+}
+
+bool FakeDecoratedClient::providesContextHelp() const
+{
+    return true;
+}
+
+bool FakeDecoratedClient::isModal() const
+{
+    return false;
+}
+
+bool FakeDecoratedClient::isShadeable() const
+{
+    return true;
+}
+
+bool FakeDecoratedClient::isMoveable() const
+{
+    return true;
+}
+
+bool FakeDecoratedClient::isResizeable() const
+{
+    return true;
+}
+
+WId FakeDecoratedClient::windowId() const
+{
+    return 0;
+}
+
+WId FakeDecoratedClient::decorationId() const
+{
+    return 0;
+}
+
+int FakeDecoratedClient::width() const
+{
+    return m_size.width();
+}
+
+int FakeDecoratedClient::height() const
+{
+    return m_size.height();
+}
+
+QSize FakeDecoratedClient::size() const
+{
+    return m_size;
+}
+
+QPalette FakeDecoratedClient::palette() const
+{
+    return m_palette;
+}
+
+//________________________________________________________________
+QColor FakeDecoratedClient::color(KDecoration2::ColorGroup group, KDecoration2::ColorRole role) const
+{
+    const QPalette::ColorGroup paletteGroup = (group == KDecoration2::ColorGroup::Inactive) ? QPalette::Inactive : QPalette::Active;
+
+    switch (role) {
+    case KDecoration2::ColorRole::TitleBar:
+    case KDecoration2::ColorRole::Frame:
+        return m_palette.color(paletteGroup, QPalette::Window);
+    case KDecoration2::ColorRole::Foreground:
+        return m_palette.color(paletteGroup, QPalette::WindowText);
+    default:
+        return QColor();
+    }
+}
+
+Qt::Edges FakeDecoratedClient::adjacentScreenEdges() const
+{
+    return m_maximized ? Qt::Edges(Qt::TopEdge | Qt::LeftEdge | Qt::RightEdge | Qt::BottomEdge) : Qt::Edges();
+}
+
+void FakeDecoratedClient::requestShowToolTip(const QString &text)
+{
+    Q_UNUSED(text);
+}
+
+void FakeDecoratedClient::requestHideToolTip()
+{
+}
+
+void FakeDecoratedClient::requestClose()
+{
+}
+
+void FakeDecoratedClient::requestToggleMaximization(Qt::MouseButtons buttons)
+{
+    Q_UNUSED(buttons);
+    setMaximized(!m_maximized);
+}
+
+void FakeDecoratedClient::requestMinimize()
+{
+}
+
+void FakeDecoratedClient::requestContextHelp()
+{
+}
+
+void FakeDecoratedClient::requestToggleOnAllDesktops()
+{
+}
+
+void FakeDecoratedClient::requestToggleShade()
+{
+}
+
+void FakeDecoratedClient::requestToggleKeepAbove()
+{
+}
+
+void FakeDecoratedClient::requestToggleKeepBelow()
+{
+}
+
+void FakeDecoratedClient::requestShowWindowMenu(const QRect &rect)
+{
+    Q_UNUSED(rect);
+}
+
+bool FakeDecoratedClient::hasApplicationMenu() const
+{
+    return false;
+}
+
+bool FakeDecoratedClient::isApplicationMenuActive() const
+{
+    return false;
+}
+
+void FakeDecoratedClient::showApplicationMenu(int actionId)
+{
+    Q_UNUSED(actionId);
+}
+
+void FakeDecoratedClient::requestShowApplicationMenu(const QRect &rect, int actionId)
+{
+    Q_UNUSED(rect);
+    Q_UNUSED(actionId);
+}
+
+QString FakeDecoratedClient::windowClass() const
+{
+    return QStringLiteral("klassy-decoration-bench klassy-decoration-bench");
+}
+
+//________________________________________________________________
+FakeDecorationSettings::FakeDecorationSettings(KDecoration2::DecorationSettings *parent)
+    : KDecoration2::DecorationSettingsPrivate(parent)
+{
+}
+
+bool FakeDecorationSettings::isAlphaChannelSupported() const
+{
+    return true;
+}
+
+bool FakeDecorationSettings::isOnAllDesktopsAvailable() const
+{
+    return true;
+}
+
+bool FakeDecorationSettings::isCloseOnDoubleClickOnMenu() const
+{
+    return false;
+}
+
+KDecoration2::BorderSize FakeDecorationSettings::borderSize() const
+{
+    return KDecoration2::BorderSize::Normal;
+}
+
+QList<KDecoration2::DecorationButtonType> FakeDecorationSettings::decorationButtonsLeft() const
+{
+    return {KDecoration2::DecorationButtonType::Menu, KDecoration2::DecorationButtonType::OnAllDesktops};
+}
+
+QList<KDecoration2::DecorationButtonType> FakeDecorationSettings::decorationButtonsRight() const
+{
+    return {KDecoration2::DecorationButtonType::ContextHelp,
+            KDecoration2::DecorationButtonType::Minimize,
+            KDecoration2::DecorationButtonType::Maximize,
+            KDecoration2::DecorationButtonType::Close};
+}
+
+//________________________________________________________________
+FakeDecorationBridge::FakeDecorationBridge(QObject *parent)
+    : KDecoration2::DecorationBridge(parent)
+{
+}
+
+std::unique_ptr<KDecoration2::DecoratedClientPrivate> FakeDecorationBridge::createClient(KDecoration2::DecoratedClient *client,
+                                                                                        KDecoration2::Decoration *decoration)
+{
+    auto fakeClient = std::make_unique<FakeDecoratedClient>(client, decoration);
+    m_lastCreatedClient = fakeClient.get();
+    return fakeClient;
+}
+
+std::unique_ptr<KDecoration2::DecorationSettingsPrivate> FakeDecorationBridge::settings(KDecoration2::DecorationSettings *parent)
+{
+    return std::make_unique<FakeDecorationSettings>(parent);
+}
+
+}
@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <KDecoration2/DecoratedClient>
+#include <KDecoration2/Decoration>
+#include <KDecoration2/DecorationSettings>
+#include <KDecoration2/Private/DecoratedClientPrivate>
+#include <KDecoration2/Private/DecorationBridge>
+#include <KDecoration2/Private/DecorationSettingsPrivate>
+
+#include <QIcon>
+#include <QPalette>
+#include <QSize>
+
+namespace Breeze
+{
+
+/**
+ * @brief Stand-in for the window a decoration is attached to, so that the decoration can be created and painted outside KWin
+ */
+class FakeDecoratedClient : public KDecoration2::DecoratedClientPrivateV2
+{
+public:
+    FakeDecoratedClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration);
+
+    //*@name state which the benchmark changes
+    //@{
+    void setActive(bool active);
+    void setSize(const QSize &size);
+    void setMaximized(bool maximized);
+    //@}
+
+    //*@name DecoratedClientPrivate
+    //@{
+    bool isActive() const override;
+    QString caption() const override;
+    bool isOnAllDesktops() const override;
+    bool isShaded() const override;
+    QIcon icon() const override;
+    bool isMaximized() const override;
+    bool isMaximizedHorizontally() const override;
+    bool isMaximizedVertically() const override;
+    bool isKeepAbove() const override;
+    bool isKeepBelow() const override;
+
+    bool isCloseable() const override;
+    bool isMaximizeable() const override;
+    bool isMinimizeable() const override;
+    bool providesContextHelp() const override;
+    bool isModal() const override;
+    bool isShadeable() const override;
+    bool isMoveable() const override;
+    bool isResizeable() const override;
+
+    WId windowId() const override;
+    WId decorationId() const override;
+
+    int width() const override;
+    int height() const override;
+    QSize size() const override;
+    QPalette palette() const override;
+    QColor color(KDecoration2::ColorGroup group, KDecoration2::ColorRole role) const override;
+    Qt::Edges adjacentScreenEdges() const override;
+
+    void requestShowToolTip(const QString &text) override;
+    void requestHideToolTip() override;
+    void requestClose() override;
+    void requestToggleMaximization(Qt::MouseButtons buttons) override;
+    void requestMinimize() override;
+    void requestContextHelp() override;
+    void requestToggleOnAllDesktops() override;
+    void requestToggleShade() override;
+    void requestToggleKeepAbove() override;
+    void requestToggleKeepBelow() override;
+    void requestShowWindowMenu(const QRect &rect) override;
+    //@}
+
+    //*@name ApplicationMenuEnabledDecoratedClientPrivate
+    //@{
+    bool hasApplicationMenu() const override;
+    bool isApplicationMenuActive() const override;
+    void showApplicationMenu(int actionId) override;
+    void requestShowApplicationMenu(const QRect &rect, int actionId) override;
+    //@}
+
+    //*@name DecoratedClientPrivateV2
+    //@{
+    QString windowClass() const override;
+    //@}
+
+private:
+    bool m_active = true;
+    bool m_maximized = false;
+    QSize m_size = QSize(800, 600);
+    QPalette m_palette;
+};
+
+/**
+ * @brief Stand-in for the KWin decoration settings
+ */
+class FakeDecorationSettings : public KDecoration2::DecorationSettingsPrivate
+{
+public:
+    explicit FakeDecorationSettings(KDecoration2::DecorationSettings *parent);
+
+    bool isAlphaChannelSupported() const override;
+    bool isOnAllDesktopsAvailable() const override;
+    bool isCloseOnDoubleClickOnMenu() const override;
+    KDecoration2::BorderSize borderSize() const override;
+    QList<KDecoration2::DecorationButtonType> decorationButtonsLeft() const override;
+    QList<KDecoration2::DecorationButtonType> decorationButtonsRight() const override;
+};
+
+/**
+ * @brief Stand-in for KWin's decoration bridge, which creates the fake client and settings
+ *        The client of the most recently created decoration is kept so that the benchmark can change its state
+ */
+class FakeDecorationBridge : public KDecoration2::DecorationBridge
+{
+    Q_OBJECT
+
+public:
+    explicit FakeDecorationBridge(QObject *parent = nullptr);
+
+    std::unique_ptr<KDecoration2::DecoratedClientPrivate> createClient(KDecoration2::DecoratedClient *client, KDecoration2::Decoration *decoration) override;
+    std::unique_ptr<KDecoration2::DecorationSettingsPrivate> settings(KDecoration2::DecorationSettings *parent) override;
+
+    FakeDecoratedClient *lastCreatedClient() const
+    {
+        return m_lastCreatedClient;
+    }
+
+private:
+    FakeDecoratedClient *m_lastCreatedClient = nullptr;
+};
+
+}
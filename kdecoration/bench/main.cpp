@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "benchmarktools.h"
+#include "decorationbenchmark.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QJsonArray>
+#include <QTemporaryDir>
+
+#include <iostream>
+
+using namespace Breeze;
+
+int main(int argc, char *argv[])
+{
+    // run headless, and against a private configuration so that the user's klassyrc is neither read nor overwritten
+    QTemporaryDir configDir;
+    if (!BenchmarkTools::setUpEnvironment(configDir, "klassy-decoration-bench")) {
+        return 1;
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("klassy-decoration-bench"));
+    app.setApplicationVersion(QStringLiteral(KLASSY_VERSION));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Times the Klassy window decoration's hot paths for each bundled preset and outputs the results as JSON"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption iterationsOption(QStringLiteral("iterations"), QStringLiteral("Number of timed runs of each operation."), QStringLiteral("n"), QStringLiteral("100"));
+    QCommandLineOption presetsDirOption(QStringLiteral("presets-dir"),
+                                        QStringLiteral("Directory of .klpw preset files to benchmark."),
+                                        QStringLiteral("directory"),
+                                        QStringLiteral(KLASSY_BENCH_PRESETS_DIR));
+    QCommandLineOption presetOption(QStringLiteral("preset"), QStringLiteral("Only benchmark the preset files whose name matches."), QStringLiteral("file name"));
+    QCommandLineOption outputOption(QStringLiteral("output"), QStringLiteral("Write the JSON results to a file rather than stdout."), QStringLiteral("file"));
+    parser.addOptions({iterationsOption, presetsDirOption, presetOption, outputOption});
+    parser.process(app);
+
+    DecorationBenchmark benchmark(parser.value(iterationsOption).toInt());
+
+    QStringList presetFilter;
+    if (parser.isSet(presetOption)) {
+        presetFilter.append(parser.value(presetOption));
+    } else {
+        presetFilter.append(QStringLiteral("*.klpw"));
+    }
+    const QDir presetsDir(parser.value(presetsDirOption));
+    const QStringList presetFiles = presetsDir.entryList(presetFilter, QDir::Files, QDir::Name);
+    if (presetFiles.isEmpty()) {
+        std::cerr << "klassy-decoration-bench: no preset files found in " << qPrintable(presetsDir.absolutePath()) << std::endl;
+        return 1;
+    }
+
+    QJsonArray presetResults;
+    for (const QString &presetFile : presetFiles) {
+        QString presetName;
+        if (!DecorationBenchmark::savePresetAsSettings(presetsDir.absoluteFilePath(presetFile), presetName)) {
+            std::cerr << "klassy-decoration-bench: skipping invalid preset file " << qPrintable(presetFile) << std::endl;
+            continue;
+        }
+
+        QJsonObject presetResult;
+        presetResult[QStringLiteral("preset")] = presetName;
+        presetResult[QStringLiteral("file")] = presetFile;
+        presetResult[QStringLiteral("decoration")] = benchmark.runDecoration();
+        presetResult[QStringLiteral("palette")] = benchmark.runPaletteStateMatrix();
+        presetResults.append(presetResult);
+    }
+
+    QJsonObject results;
+    results[QStringLiteral("benchmark")] = QStringLiteral("klassy-decoration-bench");
+    results[QStringLiteral("version")] = QStringLiteral(KLASSY_VERSION);
+    results[QStringLiteral("iterations")] = parser.value(iterationsOption).toInt();
+    results[QStringLiteral("presets")] = presetResults;
+
+    return BenchmarkTools::writeResults(results, parser.value(outputOption));
+}
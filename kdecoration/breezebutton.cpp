@@ -11,6 +11,7 @@
 #include "geometrytools.h"
 #include "renderdecorationbuttonicon.h"
 #include "systemicontheme.h"
+#include "tracing.h"
 
 #include <KColorScheme>
 #include <KColorUtils>
@@ -21,7 +22,6 @@
 
 #include <QPainter>
 #include <QPainterPath>
-#include <QVariantAnimation>
 
 namespace Breeze
 {
@@ -33,18 +33,15 @@ using KDecoration2::ColorRole;
 Button::Button(KDecoration2::DecorationButtonType type, Decoration *decoration, QObject *parent)
     : DecorationButton(type, decoration, parent)
     , m_d(qobject_cast<Decoration *>(decoration))
-    , m_animation(new QVariantAnimation(this))
+    , m_animation(new DecorationAnimation(decoration, this))
     , m_isGtkCsdButton(false)
 {
     auto c = decoration->client();
 
     // setup animation
-    // It is important start and end value are of the same type, hence 0.0 and not just 0
-    m_animation->setStartValue(0.0);
-    m_animation->setEndValue(1.0);
     m_animation->setEasingCurve(QEasingCurve::InOutQuad);
-    connect(m_animation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
-        setOpacity(value.toReal());
+    connect(m_animation, &DecorationAnimation::valueChanged, this, [this](qreal value) {
+        setOpacity(value);
     });
 
     // detect the kde-gtk-config-daemon
@@ -64,6 +61,9 @@ Button::Button(KDecoration2::DecorationButtonType type, Decoration *decoration,
     setBackgroundVisibleSize((QSizeF(smallButtonBackgroundHeight, smallButtonBackgroundHeight)));
 
     // connections
+    connect(c, &KDecoration2::DecoratedClient::iconChanged, this, [this]() {
+        m_menuIconPixmap = QPixmap();
+    });
     connect(c, SIGNAL(iconChanged(QIcon)), this, SLOT(update()));
     connect(decoration, &Decoration::reconfigured, this, &Button::reconfigure);
     connect(this, &KDecoration2::DecorationButton::hoveredChanged, this, &Button::updateAnimationState);
@@ -135,14 +135,13 @@ Button *Button::create(KDecoration2::DecorationButtonType type, KDecoration2::De
 //__________________________________________________________________
 void Button::paint(QPainter *painter, const QRect &repaintRegion)
 {
+    KLASSY_TRACE_SCOPE("decoration", "Button::paint");
     if (!geometry().intersects(repaintRegion)) {
         return;
     }
     if (!m_d) {
         return;
     }
-    auto c = m_d->client();
-
     m_buttonPalette =
         m_d->decorationColors()->buttonPalette(static_cast<DecorationButtonType>(type())); // this is in paint() in-case caching type on m_buttonPalette changes
     m_titlebarTextPinnedInversion = titlebarTextPinnedInversion();
@@ -180,18 +179,8 @@ void Button::paint(QPainter *painter, const QRect &repaintRegion)
         qreal iconTranslationOffset = (m_smallButtonPaddedSize.width() - m_iconSize.width()) / 2;
         painter->translate(iconTranslationOffset, iconTranslationOffset);
 
-        const QRectF iconRect(geometry().topLeft(), m_iconSize);
-
-        const QPalette originalPalette = KIconLoader::global()->customPalette();
-        QPalette palette = c->palette();
-        palette.setColor(QPalette::WindowText, m_foregroundColor);
-        KIconLoader::global()->setCustomPalette(palette);
-        c->icon().paint(painter, iconRect.toRect());
-        if (originalPalette == QPalette()) {
-            KIconLoader::global()->resetPalette();
-        } else {
-            KIconLoader::global()->setCustomPalette(originalPalette);
-        }
+        const QRect iconRect = QRectF(geometry().topLeft(), m_iconSize).toRect();
+        painter->drawPixmap(iconRect, menuIconPixmap(iconRect.size(), painter->device()->devicePixelRatioF()));
 
     } else {
         drawIcon(painter);
@@ -200,6 +189,40 @@ void Button::paint(QPainter *painter, const QRect &repaintRegion)
     painter->restore();
 }
 
+//__________________________________________________________________
+const QPixmap &Button::menuIconPixmap(const QSize &size, const qreal devicePixelRatio)
+{
+    const QIcon icon = m_d->client()->icon();
+    if (!m_menuIconPixmap.isNull() && m_menuIconCacheKey == icon.cacheKey() && m_menuIconPixmap.deviceIndependentSize().toSize() == size
+        && qFuzzyCompare(m_menuIconPixmap.devicePixelRatio(), devicePixelRatio) && m_menuIconColor == m_foregroundColor) {
+        return m_menuIconPixmap;
+    }
+
+    m_menuIconCacheKey = icon.cacheKey();
+    m_menuIconColor = m_foregroundColor;
+    m_menuIconPixmap = QPixmap(size * devicePixelRatio);
+    m_menuIconPixmap.setDevicePixelRatio(devicePixelRatio);
+    m_menuIconPixmap.fill(Qt::transparent);
+
+    // render with the foreground colour so that symbolic icons follow it
+    const QPalette originalPalette = KIconLoader::global()->customPalette();
+    QPalette palette = m_d->client()->palette();
+    palette.setColor(QPalette::WindowText, m_foregroundColor);
+    KIconLoader::global()->setCustomPalette(palette);
+
+    QPainter painter(&m_menuIconPixmap);
+    icon.paint(&painter, QRect(QPoint(0, 0), size));
+    painter.end();
+
+    if (originalPalette == QPalette()) {
+        KIconLoader::global()->resetPalette();
+    } else {
+        KIconLoader::global()->setCustomPalette(originalPalette);
+    }
+
+    return m_menuIconPixmap;
+}
+
 //__________________________________________________________________
 void Button::drawIcon(QPainter *painter) const
 {
@@ -301,11 +324,10 @@ QColor Button::foregroundColor(const bool getNonAnimatedColor) const
     if (!m_d)
         return QColor();
 
-    auto c = m_d->client();
-    const bool active = c->isActive();
+    const bool active = isActiveState();
 
     // return a variant of normal, hover and press colours, depending on state
-    if (isPressed()) {
+    if (isPressedState()) {
         return foregroundPressActiveStateAnimated(active, getNonAnimatedColor);
     } else if (isChecked()
                && (type() == KDecoration2::DecorationButtonType::KeepBelow || type() == KDecoration2::DecorationButtonType::KeepAbove
@@ -317,6 +339,10 @@ QColor Button::foregroundColor(const bool getNonAnimatedColor) const
             return foregroundPressActiveStateAnimated(active, getNonAnimatedColor);
         }
     } else if (m_animation->state() == QAbstractAnimation::Running && !getNonAnimatedColor) { // button hover animation
+        if (m_d->activeStateChangeAnimation()->state() != QAbstractAnimation::Running) { // use the precomputed normal to hover colours
+            DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
+            return group->foregroundHoverTransition.at(m_opacity);
+        }
         QColor foregroundNormal = foregroundNormalActiveStateAnimated(active, getNonAnimatedColor);
         QColor foregroundHover = foregroundHoverActiveStateAnimated(active, getNonAnimatedColor);
         if (foregroundNormal.isValid() && foregroundHover.isValid()) {
@@ -325,7 +351,7 @@ QColor Button::foregroundColor(const bool getNonAnimatedColor) const
             return ColorTools::alphaMix(foregroundHover, m_opacity);
         } else
             return QColor();
-    } else if (isHovered()) {
+    } else if (isHoveredState()) {
         return foregroundHoverActiveStateAnimated(active, getNonAnimatedColor);
     } else {
         return foregroundNormalActiveStateAnimated(active, getNonAnimatedColor);
@@ -335,17 +361,7 @@ QColor Button::foregroundColor(const bool getNonAnimatedColor) const
 QColor Button::foregroundNormalActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->foregroundNormal.isValid() && m_buttonPalette->inactive()->foregroundNormal.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->foregroundNormal,
-                                    m_buttonPalette->active()->foregroundNormal,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->foregroundNormal.isValid() && !m_buttonPalette->inactive()->foregroundNormal.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->foregroundNormal, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->foregroundNormal.isValid() && m_buttonPalette->inactive()->foregroundNormal.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->foregroundNormal, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else {
-            return QColor();
-        }
+        return m_buttonPalette->activeStateTransitions()->foregroundNormal.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->foregroundNormal;
@@ -355,17 +371,7 @@ QColor Button::foregroundNormalActiveStateAnimated(const bool active, const bool
 QColor Button::foregroundHoverActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->foregroundHover.isValid() && m_buttonPalette->inactive()->foregroundHover.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->foregroundHover,
-                                    m_buttonPalette->active()->foregroundHover,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->foregroundHover.isValid() && !m_buttonPalette->inactive()->foregroundHover.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->foregroundHover, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->foregroundHover.isValid() && m_buttonPalette->inactive()->foregroundHover.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->foregroundHover, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else {
-            return QColor();
-        }
+        return m_buttonPalette->activeStateTransitions()->foregroundHover.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->foregroundHover;
@@ -375,16 +381,7 @@ QColor Button::foregroundHoverActiveStateAnimated(const bool active, const bool
 QColor Button::foregroundPressActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->foregroundPress.isValid() && m_buttonPalette->inactive()->foregroundPress.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->foregroundPress,
-                                    m_buttonPalette->active()->foregroundPress,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->foregroundPress.isValid() && !m_buttonPalette->inactive()->foregroundPress.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->foregroundPress, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->foregroundPress.isValid() && m_buttonPalette->inactive()->foregroundPress.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->foregroundPress, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else
-            return QColor();
+        return m_buttonPalette->activeStateTransitions()->foregroundPress.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->foregroundPress;
@@ -398,11 +395,10 @@ QColor Button::backgroundColor(const bool getNonAnimatedColor) const
         return QColor();
     }
 
-    auto c = m_d->client();
-    const bool active = c->isActive();
+    const bool active = isActiveState();
 
     // return a variant of normal, hover and press colours, depending on state
-    if (isPressed()) {
+    if (isPressedState()) {
         return backgroundPressActiveStateAnimated(active, getNonAnimatedColor);
     } else if (isChecked()
                && (type() == KDecoration2::DecorationButtonType::KeepBelow || type() == KDecoration2::DecorationButtonType::KeepAbove
@@ -414,6 +410,10 @@ QColor Button::backgroundColor(const bool getNonAnimatedColor) const
             return backgroundPressActiveStateAnimated(active, getNonAnimatedColor);
         }
     } else if (m_animation->state() == QAbstractAnimation::Running && !getNonAnimatedColor) { // button hover animation
+        if (m_d->activeStateChangeAnimation()->state() != QAbstractAnimation::Running) { // use the precomputed normal to hover colours
+            DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
+            return group->backgroundHoverTransition.at(m_opacity);
+        }
         QColor backgroundNormal = backgroundNormalActiveStateAnimated(active, getNonAnimatedColor);
         QColor backgroundHover = backgroundHoverActiveStateAnimated(active, getNonAnimatedColor);
         if (backgroundNormal.isValid() && backgroundHover.isValid()) {
@@ -422,7 +422,7 @@ QColor Button::backgroundColor(const bool getNonAnimatedColor) const
             return ColorTools::alphaMix(backgroundHover, m_opacity);
         } else
             return QColor();
-    } else if (isHovered()) {
+    } else if (isHoveredState()) {
         return backgroundHoverActiveStateAnimated(active, getNonAnimatedColor);
     } else {
         return backgroundNormalActiveStateAnimated(active, getNonAnimatedColor);
@@ -432,17 +432,7 @@ QColor Button::backgroundColor(const bool getNonAnimatedColor) const
 QColor Button::backgroundNormalActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->backgroundNormal.isValid() && m_buttonPalette->inactive()->backgroundNormal.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->backgroundNormal,
-                                    m_buttonPalette->active()->backgroundNormal,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->backgroundNormal.isValid() && !m_buttonPalette->inactive()->backgroundNormal.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->backgroundNormal, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->backgroundNormal.isValid() && m_buttonPalette->inactive()->backgroundNormal.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->backgroundNormal, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else {
-            return QColor();
-        }
+        return m_buttonPalette->activeStateTransitions()->backgroundNormal.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->backgroundNormal;
@@ -452,17 +442,7 @@ QColor Button::backgroundNormalActiveStateAnimated(const bool active, const bool
 QColor Button::backgroundHoverActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->backgroundHover.isValid() && m_buttonPalette->inactive()->backgroundHover.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->backgroundHover,
-                                    m_buttonPalette->active()->backgroundHover,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->backgroundHover.isValid() && !m_buttonPalette->inactive()->backgroundHover.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->backgroundHover, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->backgroundHover.isValid() && m_buttonPalette->inactive()->backgroundHover.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->backgroundHover, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else {
-            return QColor();
-        }
+        return m_buttonPalette->activeStateTransitions()->backgroundHover.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->backgroundHover;
@@ -472,16 +452,7 @@ QColor Button::backgroundHoverActiveStateAnimated(const bool active, const bool
 QColor Button::backgroundPressActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->backgroundPress.isValid() && m_buttonPalette->inactive()->backgroundPress.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->backgroundPress,
-                                    m_buttonPalette->active()->backgroundPress,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->backgroundPress.isValid() && !m_buttonPalette->inactive()->backgroundPress.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->backgroundPress, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->backgroundPress.isValid() && m_buttonPalette->inactive()->backgroundPress.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->backgroundPress, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else
-            return QColor();
+        return m_buttonPalette->activeStateTransitions()->backgroundPress.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->backgroundPress;
@@ -494,11 +465,10 @@ QColor Button::outlineColor(const bool getNonAnimatedColor) const
     if (!m_d)
         return QColor();
 
-    auto c = m_d->client();
-    const bool active = c->isActive();
+    const bool active = isActiveState();
 
     // return a variant of normal, hover and press colours, depending on state
-    if (isPressed()) {
+    if (isPressedState()) {
         return outlinePressActiveStateAnimated(active, getNonAnimatedColor);
     } else if (isChecked()
                && (type() == KDecoration2::DecorationButtonType::KeepBelow || type() == KDecoration2::DecorationButtonType::KeepAbove
@@ -510,6 +480,10 @@ QColor Button::outlineColor(const bool getNonAnimatedColor) const
             return outlinePressActiveStateAnimated(active, getNonAnimatedColor);
         }
     } else if (m_animation->state() == QAbstractAnimation::Running && !getNonAnimatedColor) { // button hover animation
+        if (m_d->activeStateChangeAnimation()->state() != QAbstractAnimation::Running) { // use the precomputed normal to hover colours
+            DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
+            return group->outlineHoverTransition.at(m_opacity);
+        }
         QColor outlineHover = outlineHoverActiveStateAnimated(active, getNonAnimatedColor);
         QColor outlineNormal = outlineNormalActiveStateAnimated(active, getNonAnimatedColor);
         if (outlineNormal.isValid() && outlineHover.isValid()) {
@@ -518,7 +492,7 @@ QColor Button::outlineColor(const bool getNonAnimatedColor) const
             return ColorTools::alphaMix(outlineHover, m_opacity);
         } else
             return QColor();
-    } else if (isHovered()) {
+    } else if (isHoveredState()) {
         return outlineHoverActiveStateAnimated(active, getNonAnimatedColor);
     } else {
         return outlineNormalActiveStateAnimated(active, getNonAnimatedColor);
@@ -528,17 +502,7 @@ QColor Button::outlineColor(const bool getNonAnimatedColor) const
 QColor Button::outlineNormalActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->outlineNormal.isValid() && m_buttonPalette->inactive()->outlineNormal.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->outlineNormal,
-                                    m_buttonPalette->active()->outlineNormal,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->outlineNormal.isValid() && !m_buttonPalette->inactive()->outlineNormal.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->outlineNormal, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->outlineNormal.isValid() && m_buttonPalette->inactive()->outlineNormal.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->outlineNormal, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else {
-            return QColor();
-        }
+        return m_buttonPalette->activeStateTransitions()->outlineNormal.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->outlineNormal;
@@ -548,17 +512,7 @@ QColor Button::outlineNormalActiveStateAnimated(const bool active, const bool ge
 QColor Button::outlineHoverActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->outlineHover.isValid() && m_buttonPalette->inactive()->outlineHover.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->outlineHover,
-                                    m_buttonPalette->active()->outlineHover,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->outlineHover.isValid() && !m_buttonPalette->inactive()->outlineHover.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->outlineHover, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->outlineHover.isValid() && m_buttonPalette->inactive()->outlineHover.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->outlineHover, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else {
-            return QColor();
-        }
+        return m_buttonPalette->activeStateTransitions()->outlineHover.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->outlineHover;
@@ -568,16 +522,7 @@ QColor Button::outlineHoverActiveStateAnimated(const bool active, const bool get
 QColor Button::outlinePressActiveStateAnimated(const bool active, const bool getNonAnimatedColor) const
 {
     if (!getNonAnimatedColor && m_d->activeStateChangeAnimation()->state() == QAbstractAnimation::Running) {
-        if (m_buttonPalette->active()->outlinePress.isValid() && m_buttonPalette->inactive()->outlinePress.isValid()) {
-            return KColorUtils::mix(m_buttonPalette->inactive()->outlinePress,
-                                    m_buttonPalette->active()->outlinePress,
-                                    m_d->activeStateChangeAnimationOpacity());
-        } else if (m_buttonPalette->active()->outlinePress.isValid() && !m_buttonPalette->inactive()->outlinePress.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->active()->outlinePress, m_d->activeStateChangeAnimationOpacity());
-        } else if (!m_buttonPalette->active()->outlinePress.isValid() && m_buttonPalette->inactive()->outlinePress.isValid()) {
-            return ColorTools::alphaMix(m_buttonPalette->inactive()->outlinePress, (1.0 - m_d->activeStateChangeAnimationOpacity()));
-        } else
-            return QColor();
+        return m_buttonPalette->activeStateTransitions()->outlinePress.at(m_d->activeStateChangeAnimationOpacity());
     } else {
         DecorationButtonPaletteGroup *group = active ? m_buttonPalette->active() : m_buttonPalette->inactive();
         return group->outlinePress;
@@ -588,8 +533,7 @@ bool Button::titlebarTextPinnedInversion() const
 {
     if (!m_d)
         return false;
-    auto c = m_d->client();
-    bool active = c->isActive();
+    bool active = isActiveState();
 
     return type() == KDecoration2::DecorationButtonType::OnAllDesktops
         && m_d->internalSettings()->buttonIconStyle() != InternalSettings::EnumButtonIconStyle::StyleSystemIconTheme
@@ -609,6 +553,24 @@ bool Button::titlebarTextPinnedInversion() const
         && !m_d->internalSettings()->showBackgroundNormally(active); // inversion occuring for compatibility with breeze's circular pin on all desktops icon
 }
 
+//__________________________________________________________________
+bool Button::isActiveState() const
+{
+    return m_exportState ? m_exportState->active : m_d->client()->isActive();
+}
+
+//__________________________________________________________________
+bool Button::isHoveredState() const
+{
+    return m_exportState ? m_exportState->hovered : isHovered();
+}
+
+//__________________________________________________________________
+bool Button::isPressedState() const
+{
+    return m_exportState ? m_exportState->pressed : isPressed();
+}
+
 //________________________________________________________________
 void Button::reconfigure()
 {
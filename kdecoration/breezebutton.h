@@ -9,13 +9,15 @@
 #pragma once
 
 #include "breezedecoration.h"
+#include "breezedecorationanimation.h"
 #include "decorationbuttoncolors.h"
 #include <KDecoration2/DecorationButton>
 
 #include <QHash>
 #include <QImage>
+#include <QPixmap>
 
-class QVariantAnimation;
+#include <optional>
 
 namespace Breeze
 {
@@ -158,7 +160,8 @@ public:
             return;
         }
         m_opacity = value;
-        update();
+        // coalesced with the other animated repaints of the decoration for this tick
+        DecorationAnimationScheduler::self()->scheduleUpdate(m_d, geometry().toAlignedRect());
     }
 
     qreal opacity() const
@@ -168,6 +171,20 @@ public:
 
     //@}
 
+    //* state to paint a standalone button in, rather than that of the client and pointer; used to export GTK CSD button assets
+    struct ExportState {
+        bool active = true;
+        bool hovered = false;
+        bool pressed = false;
+    };
+
+    //* paint with the given state, with the non-animated colours and non-cosmetic pens used for GTK CSD buttons
+    void setExportState(const ExportState &state)
+    {
+        m_exportState = state;
+        m_isGtkCsdButton = true;
+    }
+
 private Q_SLOTS:
 
     //* apply configuration changes
@@ -186,6 +203,9 @@ private:
     //* draw button icon
     void drawIcon(QPainter *) const;
 
+    //* the client's icon rendered for the menu button, re-rendered only when the icon, size, device pixel ratio or foreground colour changes
+    const QPixmap &menuIconPixmap(const QSize &size, const qreal devicePixelRatio);
+
     //*@name colors
     //@{
     QColor backgroundColor(const bool getNonAnimatedColor = false) const;
@@ -229,6 +249,13 @@ private:
     //* Whether to invert the pinned-on-all-desktops icon like in Breeze
     bool titlebarTextPinnedInversion() const;
 
+    //*@name state to paint in, taken from the export state if set
+    //@{
+    bool isActiveState() const;
+    bool isHoveredState() const;
+    bool isPressedState() const;
+    //@}
+
     //* Pointer to the decoration
     Decoration *m_d;
 
@@ -248,8 +275,8 @@ private:
     bool m_rightmostRightVisible = false;
     bool m_visibleBeforeMenu = false;
 
-    //* active state change animation
-    QVariantAnimation *m_animation;
+    //* hover animation
+    DecorationAnimation *m_animation;
 
     //* icon offset (for rendering)
     mutable QPointF m_iconOffset;
@@ -279,6 +306,14 @@ private:
     qreal m_standardScaledCosmeticPenWidth = 1.0;
     mutable qreal m_standardScaledNonCosmeticPenWidth = 1.0;
     bool m_titlebarTextPinnedInversion = false;
+    std::optional<ExportState> m_exportState;
+
+    //*@name cached menu button icon
+    //@{
+    QPixmap m_menuIconPixmap;
+    qint64 m_menuIconCacheKey = 0;
+    QColor m_menuIconColor;
+    //@}
 };
 
 } // namespace
@@ -15,9 +15,13 @@
 
 #include "breezeboxshadowrenderer.h"
 #include "breezebutton.h"
+#include "breezedecorationreconfigurequeue.h"
+#include "breezegtkcsdbuttonexporter.h"
 #include "breezesettingsprovider.h"
 #include "dbusupdatenotifier.h"
 #include "geometrytools.h"
+#include "statistics.h"
+#include "tracing.h"
 
 #include <KDecoration2/DecorationButtonGroup>
 #include <KDecoration2/DecorationShadow>
@@ -27,16 +31,16 @@
 #include <KPluginFactory>
 #include <KWindowSystem>
 
-#include <QDBusConnection>
-#include <QDBusMessage>
-#include <QDBusPendingCallWatcher>
-#include <QDBusPendingReply>
+#include <QCache>
+#include <QDataStream>
+#include <QHash>
 #include <QPainter>
 #include <QTextStream>
 #include <QTimer>
 
 #include <cmath>
 #include <mutex>
+#include <optional>
 
 K_PLUGIN_FACTORY_WITH_JSON(BreezeDecoFactory, "breeze.json", registerPlugin<Breeze::Decoration>(); registerPlugin<Breeze::Button>();)
 
@@ -145,12 +149,57 @@ static qreal g_thinWindowOutlineThickness = 1;
 static std::shared_ptr<KDecoration2::DecorationShadow> g_sShadow;
 static std::shared_ptr<KDecoration2::DecorationShadow> g_sShadowInactive;
 
+// blurred and masked shadow textures without the thin window outline, so that outline colour changes and animations do not re-run the blur
+struct ShadowTexture {
+    QImage texture;
+    QMargins padding;
+    QRectF innerRect;
+};
+//* enough for the active and inactive shadows of a few differing settings, while bounding the memory used during shadow animations
+static constexpr int s_shadowTexturesCacheSize = 8;
+//* each texture costs 1, so that the least recently used one is evicted once the cache is full
+static QCache<QByteArray, ShadowTexture> g_shadowTextures(s_shadowTexturesCacheSize);
+
+// configuration-derived state shared by every decoration, adopted by newly mapped windows until a configuration change notification invalidates it
+struct DecorationTemplate {
+    qreal systemScaleFactorX11 = 1;
+    QString lookAndFeelPackage;
+    float animationDurationFactor = 1.0f;
+    bool colorSchemeHasHeaderColor = false;
+    //* the application palette of the system colour scheme, which every decoration compares its client palette against
+    QPalette systemPalette;
+    //* global palette change notification which the template was last refreshed for
+    QByteArray globalPaletteUpdateUuid;
+};
+static std::optional<DecorationTemplate> g_decorationTemplate;
+
+// decoration colours shared between windows with the same client-specific colour scheme
+struct ClientPaletteDecorationColors {
+    std::weak_ptr<DecorationColors> colors;
+    //* settings update request which the colours were last generated for
+    QByteArray settingsUpdateUuid;
+};
+static QHash<QByteArray, ClientPaletteDecorationColors> g_clientPaletteDecorationColors;
+
+//________________________________________________________________
+static QByteArray clientPaletteDecorationColorsKey(const QPalette &palette,
+                                                   const QColor &titleBarTextActive,
+                                                   const QColor &titleBarBaseActive,
+                                                   const QColor &titleBarTextInactive,
+                                                   const QColor &titleBarBaseInactive)
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << palette << titleBarTextActive << titleBarBaseActive << titleBarTextInactive << titleBarBaseInactive;
+    return key;
+}
+
 //________________________________________________________________
 Decoration::Decoration(QObject *parent, const QVariantList &args)
     : KDecoration2::Decoration(parent, args)
-    , m_animation(new QVariantAnimation(this))
-    , m_shadowAnimation(new QVariantAnimation(this))
-    , m_overrideOutlineFromButtonAnimation(new QVariantAnimation(this))
+    , m_animation(new DecorationAnimation(this, this))
+    , m_shadowAnimation(new DecorationAnimation(this, this))
+    , m_overrideOutlineFromButtonAnimation(new DecorationAnimation(this, this))
 
 {
 #if KLASSY_DECORATION_DEBUG_MODE
@@ -159,6 +208,10 @@ Decoration::Decoration(QObject *parent, const QVariantList &args)
     if (!s_kdeGlobalConfig) {
         s_kdeGlobalConfig = KSharedConfig::openConfig();
     }
+    if (!g_sDecoCount) {
+        // make the cache and animation counters readable with "klassy-settings --stats"
+        Statistics::self()->registerOnSessionBus();
+    }
     g_sDecoCount++;
 }
 
@@ -169,9 +222,56 @@ Decoration::~Decoration()
     if (g_sDecoCount == 0) {
         // last deco destroyed, clean up shadow
         g_sShadow.reset();
+        g_shadowTextures.clear();
     }
 }
 
+//________________________________________________________________
+void Decoration::invalidateDecorationTemplate()
+{
+    g_decorationTemplate.reset();
+}
+
+//________________________________________________________________
+static const DecorationTemplate &currentDecorationTemplate(const KSharedConfig::Ptr &kdeGlobalConfig)
+{
+    if (g_decorationTemplate) {
+        return *g_decorationTemplate;
+    }
+
+    DecorationTemplate decorationTemplate;
+    if (KWindowSystem::isPlatformX11()) {
+        // loads system ScaleFactor from ~/.config/kdeglobals
+        const KConfigGroup cgKScreen(kdeGlobalConfig, QStringLiteral("KScreen"));
+        decorationTemplate.systemScaleFactorX11 = cgKScreen.readEntry("ScaleFactor", 1.0f);
+    }
+    const KConfigGroup cg(kdeGlobalConfig, QStringLiteral("KDE"));
+    decorationTemplate.lookAndFeelPackage = cg.readEntry("LookAndFeelPackage");
+    decorationTemplate.animationDurationFactor = cg.readEntry("AnimationDurationFactor", 1.0f);
+    decorationTemplate.colorSchemeHasHeaderColor = KColorScheme::isColorSetSupported(kdeGlobalConfig, KColorScheme::Header);
+    decorationTemplate.systemPalette = KColorScheme::createApplicationPalette(kdeGlobalConfig);
+    g_decorationTemplate = decorationTemplate;
+    return *g_decorationTemplate;
+}
+
+//________________________________________________________________
+int Decoration::exportGtkCsdButtons(const QString &directoryPath, int buttonSize, const QList<qreal> &scales)
+{
+    if (!m_gtkCsdButtonExporter) {
+        m_gtkCsdButtonExporter = std::make_unique<GtkCsdButtonExporter>(this);
+    }
+    return m_gtkCsdButtonExporter->exportToDirectory(directoryPath, buttonSize, scales);
+}
+
+//________________________________________________________________
+QImage Decoration::renderGtkCsdButtonAtlas(int buttonSize, qreal scale)
+{
+    if (!m_gtkCsdButtonExporter) {
+        m_gtkCsdButtonExporter = std::make_unique<GtkCsdButtonExporter>(this);
+    }
+    return m_gtkCsdButtonExporter->renderAtlas(buttonSize, scale);
+}
+
 //________________________________________________________________
 void Decoration::setOpacity(qreal value)
 {
@@ -179,7 +279,7 @@ void Decoration::setOpacity(qreal value)
         return;
     }
     m_opacity = value;
-    update();
+    DecorationAnimationScheduler::self()->scheduleUpdate(this);
 }
 
 //________________________________________________________________
@@ -290,68 +390,42 @@ void Decoration::init()
     reconfigureMain(true);
     
     // active state change animation
-    // It is important start and end value are of the same type, hence 0.0 and not just 0
-    m_animation->setStartValue(0.0);
-    m_animation->setEndValue(1.0);
+    // all animations are advanced from the shared DecorationAnimationScheduler tick, which also coalesces the resulting repaints
     // Linear to have the same easing as Breeze animations
     m_animation->setEasingCurve(QEasingCurve::Linear);
-    connect(m_animation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
-        setOpacity(value.toReal());
+    connect(m_animation, &DecorationAnimation::valueChanged, this, [this](qreal value) {
+        setOpacity(value);
     });
 
-    m_shadowAnimation->setStartValue(0.0);
-    m_shadowAnimation->setEndValue(1.0);
     m_shadowAnimation->setEasingCurve(QEasingCurve::OutCubic);
-    connect(m_shadowAnimation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
-        m_shadowOpacity = value.toReal();
+    connect(m_shadowAnimation, &DecorationAnimation::valueChanged, this, [this](qreal value) {
+        m_shadowOpacity = value;
         if (m_shadowAnimation->state() == QAbstractAnimation::Running)
             updateShadow();
     });
 
-    m_overrideOutlineFromButtonAnimation->setStartValue(0.0);
-    m_overrideOutlineFromButtonAnimation->setEndValue(1.0);
     m_overrideOutlineFromButtonAnimation->setEasingCurve(QEasingCurve::InOutQuad);
 
-    connect(m_overrideOutlineFromButtonAnimation, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
-        m_overrideOutlineAnimationProgress = value.toReal();
+    connect(m_overrideOutlineFromButtonAnimation, &DecorationAnimation::valueChanged, this, [this](qreal value) {
+        m_overrideOutlineAnimationProgress = value;
         if (m_overrideOutlineFromButtonAnimation->state() == QAbstractAnimation::Running)
             updateShadow(false, true, true);
     });
 
-    // use DBus connection to update on Klassy configuration change
-    auto dbus = QDBusConnection::sessionBus();
-
-    dbus.connect(QString(),
-                 QStringLiteral("/KGlobalSettings"),
-                 QStringLiteral("org.kde.KGlobalSettings"),
-                 QStringLiteral("notifyChange"),
-                 this,
-                 SLOT(reconfigure()));
-
-    // Implement tablet mode DBus connection
-    dbus.connect(QStringLiteral("org.kde.KWin"),
-                 QStringLiteral("/org/kde/KWin"),
-                 QStringLiteral("org.kde.KWin.TabletModeManager"),
-                 QStringLiteral("tabletModeChanged"),
-                 QStringLiteral("b"),
-                 this,
-                 SLOT(onTabletModeChanged(bool)));
-
-    auto message = QDBusMessage::createMethodCall(QStringLiteral("org.kde.KWin"),
-                                                  QStringLiteral("/org/kde/KWin"),
-                                                  QStringLiteral("org.freedesktop.DBus.Properties"),
-                                                  QStringLiteral("Get"));
-    message.setArguments({QStringLiteral("org.kde.KWin.TabletModeManager"), QStringLiteral("tabletMode")});
-    auto call = new QDBusPendingCallWatcher(dbus.asyncCall(message), this);
-    connect(call, &QDBusPendingCallWatcher::finished, this, [this, call]() {
-        QDBusPendingReply<QVariant> reply = *call;
-        if (!reply.isError()) {
-            onTabletModeChanged(reply.value().toBool());
-        }
-
-        call->deleteLater();
+    // KGlobalSettings changes are filtered and debounced centrally, and only the minimal update is dispatched
+    DBusUpdateNotifier::self()->subscribeGlobalSettings();
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::globalPaletteUpdate, this, &Decoration::updateOnGlobalPaletteChange);
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::globalFontsUpdate, this, &Decoration::updateOnGlobalFontsChange);
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::globalSettingsUpdate, this, [this]() {
+        DecorationReconfigureQueue::self()->schedule(this);
     });
 
+    // tablet mode is subscribed to and queried once per process, with the state cached for later decorations
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::tabletModeChanged, this, &Decoration::onTabletModeChanged);
+    if (DBusUpdateNotifier::self()->tabletMode()) {
+        onTabletModeChanged(true);
+    }
+
     updateTitleBar();
     auto s = settings();
     connect(s.get(), &KDecoration2::DecorationSettings::borderSizeChanged, this, &Decoration::recalculateBorders);
@@ -365,9 +439,9 @@ void Decoration::init()
 
     // color cache update
     // The slot will only update if the UUID has changed, hence preventing unnecessary multiple colour cache updates
-    connect(&g_dBusUpdateNotifier, &DBusUpdateNotifier::decorationSettingsUpdate, this, &Decoration::generateDecorationColorsOnDecorationColorSettingsUpdate);
-    connect(&g_dBusUpdateNotifier, &DBusUpdateNotifier::systemColorSchemeUpdate, this, &Decoration::generateDecorationColorsOnSystemColorSettingsUpdate);
-    connect(&g_dBusUpdateNotifier, &DBusUpdateNotifier::systemIconsUpdate, this, [this]() {
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::decorationSettingsUpdate, this, &Decoration::generateDecorationColorsOnDecorationColorSettingsUpdate);
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::systemColorSchemeUpdate, this, &Decoration::generateDecorationColorsOnSystemColorSettingsUpdate);
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::systemIconsUpdate, this, [this]() {
         if (m_internalSettings->buttonIconStyle() == InternalSettings::EnumButtonIconStyle::StyleSystemIconTheme) {
             Q_EMIT reconfigured(); // this will trigger Button::reconfigure
         }
@@ -379,9 +453,10 @@ void Decoration::init()
     connect(s.get(), &KDecoration2::DecorationSettings::decorationButtonsLeftChanged, this, &Decoration::updateButtonsGeometryDelayed);
     connect(s.get(), &KDecoration2::DecorationSettings::decorationButtonsRightChanged, this, &Decoration::updateButtonsGeometryDelayed);
 
-    // full reconfiguration
-    connect(s.get(), &KDecoration2::DecorationSettings::reconfigured, this, &Decoration::reconfigure);
-    connect(s.get(), &KDecoration2::DecorationSettings::reconfigured, this, &Decoration::updateButtonsGeometryDelayed);
+    // full reconfiguration, batched with that of all other decorations into one deferred pass
+    connect(s.get(), &KDecoration2::DecorationSettings::reconfigured, this, [this]() {
+        DecorationReconfigureQueue::self()->schedule(this);
+    });
 
     connect(c, &KDecoration2::DecoratedClient::adjacentScreenEdgesChanged, this, &Decoration::recalculateBorders);
     connect(c, &KDecoration2::DecoratedClient::maximizedHorizontallyChanged, this, &Decoration::recalculateBorders);
@@ -402,7 +477,7 @@ void Decoration::init()
     connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::updateTitleBar);
     connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::updateOpaque);
 
-    connect(c, &KDecoration2::DecoratedClient::widthChanged, this, &Decoration::updateButtonsGeometry);
+    connect(c, &KDecoration2::DecoratedClient::widthChanged, this, &Decoration::updateButtonsGeometryOnWidthChange);
     connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::updateButtonsGeometry);
     connect(c, &KDecoration2::DecoratedClient::adjacentScreenEdgesChanged, this, &Decoration::updateButtonsGeometry);
     connect(c, &KDecoration2::DecoratedClient::shadedChanged, this, &Decoration::updateButtonsGeometry);
@@ -536,21 +611,31 @@ int Decoration::borderSize(bool bottom) const
 }
 
 //________________________________________________________________
-void Decoration::reconfigureMain(const bool noUpdateShadow)
+void Decoration::reconfigureMain(const bool noUpdateShadow, const bool reloadConfig)
 {
     auto c = client();
 
-    SettingsProvider::self()->reconfigure();
+    // the shared configuration is only reloaded and re-read once a configuration change notification has invalidated the decoration template, so that
+    // mapping a window normally just adopts the current template without touching the configuration files
+    const bool templateCurrent = g_decorationTemplate.has_value();
+    if (templateCurrent) {
+        Statistics::self()->recordCacheHit("decorationTemplate");
+    } else {
+        Statistics::self()->recordCacheMiss("decorationTemplate");
+    }
+
+    if (reloadConfig && !templateCurrent) {
+        SettingsProvider::self()->reconfigure();
+        s_kdeGlobalConfig->reparseConfiguration();
+    }
+    const DecorationTemplate &decorationTemplate = currentDecorationTemplate(s_kdeGlobalConfig);
     m_internalSettings = SettingsProvider::self()->internalSettings(this);
 
     QPalette clientPalette = c->palette();
     updateDecorationColors(clientPalette);
 
-    s_kdeGlobalConfig->reparseConfiguration();
     if (KWindowSystem::isPlatformX11()) {
-        // loads system ScaleFactor from ~/.config/kdeglobals
-        const KConfigGroup cgKScreen(s_kdeGlobalConfig, QStringLiteral("KScreen"));
-        m_systemScaleFactorX11 = cgKScreen.readEntry("ScaleFactor", 1.0f);
+        m_systemScaleFactorX11 = decorationTemplate.systemScaleFactorX11;
     }
 
     setScaledCornerRadius();
@@ -567,11 +652,9 @@ void Decoration::reconfigureMain(const bool noUpdateShadow)
 
     calculateButtonHeights();
 
-    const KConfigGroup cg(s_kdeGlobalConfig, QStringLiteral("KDE"));
-
-    setGlobalLookAndFeelOptions(cg.readEntry("LookAndFeelPackage"));
+    setGlobalLookAndFeelOptions(decorationTemplate.lookAndFeelPackage);
 
-    m_colorSchemeHasHeaderColor = KColorScheme::isColorSetSupported(s_kdeGlobalConfig, KColorScheme::Header);
+    m_colorSchemeHasHeaderColor = decorationTemplate.colorSchemeHasHeaderColor;
 
     // m_toolsAreaWillBeDrawn = ( m_colorSchemeHasHeaderColor && ( settings()->borderSize() == KDecoration2::BorderSize::None || settings()->borderSize() ==
     // KDecoration2::BorderSize::NoSides ) );
@@ -584,7 +667,7 @@ void Decoration::reconfigureMain(const bool noUpdateShadow)
             animationsDurationFactorRelativeSystem = (-m_internalSettings->animationsSpeedRelativeSystem() + 2) / 2.0f;
         else if (m_internalSettings->animationsSpeedRelativeSystem() > 0)
             animationsDurationFactorRelativeSystem = 1 / ((m_internalSettings->animationsSpeedRelativeSystem() + 2) / 2.0f);
-        m_animation->setDuration(cg.readEntry("AnimationDurationFactor", 1.0f) * 150.0f * animationsDurationFactorRelativeSystem);
+        m_animation->setDuration(decorationTemplate.animationDurationFactor * 150.0f * animationsDurationFactorRelativeSystem);
         m_shadowAnimation->setDuration(m_animation->duration());
         m_overrideOutlineFromButtonAnimation->setDuration(m_animation->duration());
     } else {
@@ -608,7 +691,7 @@ void Decoration::reconfigureMain(const bool noUpdateShadow)
 
 void Decoration::updateDecorationColors(const QPalette &clientPalette, QByteArray uuid)
 {
-    QPalette systemPalette = KColorScheme::createApplicationPalette(s_kdeGlobalConfig);
+    const QPalette &systemPalette = currentDecorationTemplate(s_kdeGlobalConfig).systemPalette;
     bool clientSpecificPalette = false;
     if (clientPalette != systemPalette) { // Some applications can set a Window Colour Scheme, meaning the client palette and system palette differ
         clientSpecificPalette = true;
@@ -616,45 +699,79 @@ void Decoration::updateDecorationColors(const QPalette &clientPalette, QByteArra
 
     // The preset exception may modify the decoration colours by having a different translucentButtonBackgroundsOpacity, so in this case we don't want to
     // cache the decoration colours as it may corrupt the colours for normal non-exception decoration windows
-    bool noCache = m_internalSettings->property("noCacheException").toBool() || clientSpecificPalette;
-
-    if (noCache) {
-        if (!m_decorationColors || m_decorationColors->isCachedPalette()) {
-            m_decorationColors = std::make_unique<DecorationColors>(false);
-        }
-    } else {
-        if (!m_decorationColors || !m_decorationColors->isCachedPalette()) {
-            m_decorationColors = std::make_unique<DecorationColors>(true);
-        }
-    }
+    bool noCacheException = m_internalSettings->property("noCacheException").toBool();
+    bool noCache = noCacheException || clientSpecificPalette;
 
     QPalette palette = clientSpecificPalette ? clientPalette : systemPalette;
+
+    auto c = client();
+    QColor activeTitleBarBase = c->color(ColorGroup::Active, ColorRole::TitleBar);
+    QColor inactiveTitlebarBase = c->color(ColorGroup::Inactive, ColorRole::TitleBar);
+    QColor activeTitleBarText = c->color(ColorGroup::Active, ColorRole::Foreground);
+    QColor inactiveTitleBarText = c->color(ColorGroup::Inactive, ColorRole::Foreground);
+
     bool generateColors = false;
 
-    if (!m_decorationColors->areColorsGenerated()) {
-        generateColors = true;
-    } else {
-        if (!uuid.isEmpty()
-            && (noCache
-                || (!noCache && uuid != m_decorationColors->settingsUpdateUuid()))) { // case from generateDecorationColorsOnDecorationSettingsPaletteUpdate()
+    if (clientSpecificPalette && !noCacheException) {
+        // windows with the same client colour scheme share one generated DecorationColors, which is freed when the last of them drops it
+        const QByteArray poolKey = clientPaletteDecorationColorsKey(palette, activeTitleBarText, activeTitleBarBase, inactiveTitleBarText, inactiveTitlebarBase);
+        auto pooledColors = g_clientPaletteDecorationColors.find(poolKey);
+        std::shared_ptr<DecorationColors> decorationColors = pooledColors != g_clientPaletteDecorationColors.end() ? pooledColors->colors.lock() : nullptr;
+
+        if (!decorationColors) {
+            Statistics::self()->recordCacheMiss("clientPaletteDecorationColors");
+
+            // drop entries whose windows have all gone before adding a new one
+            g_clientPaletteDecorationColors.removeIf([](const auto &entry) {
+                return entry.value().colors.expired();
+            });
+
+            decorationColors = std::make_shared<DecorationColors>(false);
+            pooledColors = g_clientPaletteDecorationColors.insert(poolKey, ClientPaletteDecorationColors{decorationColors, QByteArray()});
+            Statistics::self()->setGauge("clientPaletteDecorationColors.entries", g_clientPaletteDecorationColors.count());
+        } else {
+            Statistics::self()->recordCacheHit("clientPaletteDecorationColors");
+        }
+
+        m_decorationColors = decorationColors;
+        m_decorationColorsPooled = true;
+
+        if (!m_decorationColors->areColorsGenerated() || (!uuid.isEmpty() && uuid != pooledColors->settingsUpdateUuid)) {
             generateColors = true;
+            if (!uuid.isEmpty()) {
+                pooledColors->settingsUpdateUuid = uuid;
+            }
         }
+    } else {
+        if (noCache) {
+            if (!m_decorationColors || m_decorationColors->isCachedPalette() || m_decorationColorsPooled) {
+                m_decorationColors = std::make_shared<DecorationColors>(false);
+            }
+        } else {
+            if (!m_decorationColors || !m_decorationColors->isCachedPalette()) {
+                m_decorationColors = std::make_shared<DecorationColors>(true);
+            }
+        }
+        m_decorationColorsPooled = false;
 
-        // TODO: palette may not be a reliable indicator of the entire colour scheme - get an update to KDecoration2::DecoratedClient to read QString
-        // m_colorScheme instead
-        if (!generateColors && palette != *m_decorationColors->basePalette()) {
+        if (!m_decorationColors->areColorsGenerated()) {
             generateColors = true;
+        } else {
+            if (!uuid.isEmpty()
+                && (noCache
+                    || (!noCache && uuid != m_decorationColors->settingsUpdateUuid()))) { // case from generateDecorationColorsOnDecorationSettingsPaletteUpdate()
+                generateColors = true;
+            }
+
+            // TODO: palette may not be a reliable indicator of the entire colour scheme - get an update to KDecoration2::DecoratedClient to read QString
+            // m_colorScheme instead
+            if (!generateColors && palette != *m_decorationColors->basePalette()) {
+                generateColors = true;
+            }
         }
     }
 
     if (generateColors) {
-        auto c = client();
-
-        QColor activeTitleBarBase = c->color(ColorGroup::Active, ColorRole::TitleBar);
-        QColor inactiveTitlebarBase = c->color(ColorGroup::Inactive, ColorRole::TitleBar);
-        QColor activeTitleBarText = c->color(ColorGroup::Active, ColorRole::Foreground);
-        QColor inactiveTitleBarText = c->color(ColorGroup::Inactive, ColorRole::Foreground);
-
         m_decorationColors->generateDecorationAndButtonColors(palette,
                                                               m_internalSettings,
                                                               activeTitleBarText,
@@ -677,27 +794,52 @@ void Decoration::generateDecorationColorsOnClientPaletteUpdate(const QPalette &c
 
 void Decoration::generateDecorationColorsOnDecorationColorSettingsUpdate(QByteArray uuid)
 {
-    auto c = client();
-    QPalette clientPalette = c->palette();
-
-    SettingsProvider::self()->reconfigure();
-    m_internalSettings = SettingsProvider::self()->internalSettings(this);
-    s_kdeGlobalConfig->reparseConfiguration();
-
-    updateDecorationColors(clientPalette, uuid);
+    // batched with all other decorations, so that the configuration is reloaded once per settings change
+    DecorationReconfigureQueue::self()->scheduleColors(this, uuid);
 }
 
 void Decoration::generateDecorationColorsOnSystemColorSettingsUpdate(QByteArray uuid)
 {
-    auto c = client();
-    QPalette clientPalette = c->palette();
+    DecorationReconfigureQueue::self()->scheduleColors(this, uuid);
+    DecorationReconfigureQueue::self()->schedule(this);
+}
 
-    SettingsProvider::self()->reconfigure();
+void Decoration::regenerateDecorationColors(QByteArray uuid)
+{
     m_internalSettings = SettingsProvider::self()->internalSettings(this);
-    s_kdeGlobalConfig->reparseConfiguration();
+    updateDecorationColors(client()->palette(), uuid);
+}
 
-    updateDecorationColors(clientPalette, uuid);
-    reconfigure();
+void Decoration::updateOnGlobalPaletteChange(QByteArray uuid)
+{
+    // kdeglobals is reloaded and the template refreshed by the first decoration to receive the notification, and adopted by the rest
+    if (!g_decorationTemplate || g_decorationTemplate->globalPaletteUpdateUuid != uuid) {
+        s_kdeGlobalConfig->reparseConfiguration();
+        invalidateDecorationTemplate();
+        currentDecorationTemplate(s_kdeGlobalConfig);
+        g_decorationTemplate->globalPaletteUpdateUuid = uuid;
+    }
+
+    updateDecorationColors(client()->palette(), uuid);
+
+    m_colorSchemeHasHeaderColor = g_decorationTemplate->colorSchemeHasHeaderColor;
+    m_toolsAreaWillBeDrawn = (m_colorSchemeHasHeaderColor);
+
+    // the titlebar opacity, and hence the opaque flag and blur region, follow the regenerated colours
+    updateOpaque();
+    updateBlur();
+
+    updateShadow();
+    update();
+}
+
+void Decoration::updateOnGlobalFontsChange()
+{
+    // the grid unit, and hence the button sizes and borders, depend on the font
+    calculateButtonHeights();
+    recalculateBorders();
+    updateTitleBar();
+    updateButtonsGeometry();
 }
 
 void Decoration::setGlobalLookAndFeelOptions(QString lookAndFeelPackageName)
@@ -1072,36 +1214,84 @@ void Decoration::updateButtonsGeometry()
     }
 
     // right buttons
+    m_rightButtonsPlaced = false;
     if (!m_rightButtons->buttons().isEmpty() && rightmostRightVisibleIndex != -1) {
         // spacing
         m_rightButtons->setSpacing(buttonSpacingRight);
 
         // padding
-        int vPadding;
         if (m_buttonBackgroundType == ButtonBackgroundType::FullHeight)
-            vPadding = 0;
+            m_rightButtonsVPadding = 0;
         else
-            vPadding = isTopEdge() ? 0 : buttonTopMargin;
+            m_rightButtonsVPadding = isTopEdge() ? 0 : buttonTopMargin;
         const int hPadding = m_scaledTitleBarRightMargin;
 
         auto lastButton = static_cast<Button *>(m_rightButtons->buttons()[rightmostRightVisibleIndex]);
         lastButton->setFlag(Button::FlagLastInList);
         if (isRightEdge()) {
             lastButton->setGeometry(QRectF(QPoint(0, 0), QSizeF(lastButton->geometry().width() + hPadding, lastButton->geometry().height())));
+        }
 
-            m_rightButtons->setPos(QPointF(size().width() - m_rightButtons->geometry().width(), vPadding));
+        m_rightButtonsPlaced = true;
+        updateRightButtonsPosition();
+    }
 
-        } else {
-            m_rightButtons->setPos(QPointF(size().width() - m_rightButtons->geometry().width() - hPadding - borderRight(), vPadding));
-        }
+    m_buttonsLayoutValid = true;
+    m_buttonsLayoutRightEdge = isRightEdge();
+    m_buttonsLayoutVisibility = buttonsVisibility();
+
+    update();
+}
+
+//________________________________________________________________
+void Decoration::updateButtonsGeometryOnWidthChange()
+{
+    // only the right button group's position depends on the width, so the full layout is only redone if something else it depends on has changed
+    if (!m_buttonsLayoutValid || isRightEdge() != m_buttonsLayoutRightEdge || buttonsVisibility() != m_buttonsLayoutVisibility) {
+        updateButtonsGeometry();
+        return;
     }
 
+    updateRightButtonsPosition();
     update();
 }
 
+//________________________________________________________________
+void Decoration::updateRightButtonsPosition()
+{
+    if (!m_rightButtonsPlaced) {
+        return;
+    }
+
+    if (isRightEdge()) {
+        m_rightButtons->setPos(QPointF(size().width() - m_rightButtons->geometry().width(), m_rightButtonsVPadding));
+    } else {
+        m_rightButtons->setPos(
+            QPointF(size().width() - m_rightButtons->geometry().width() - m_scaledTitleBarRightMargin - borderRight(), m_rightButtonsVPadding));
+    }
+}
+
+//________________________________________________________________
+QBitArray Decoration::buttonsVisibility() const
+{
+    const auto leftButtons = m_leftButtons->buttons();
+    const auto rightButtons = m_rightButtons->buttons();
+
+    QBitArray visibility(leftButtons.count() + rightButtons.count());
+    int i = 0;
+    for (const auto &button : leftButtons) {
+        visibility.setBit(i++, button->isVisible() && button->isEnabled());
+    }
+    for (const auto &button : rightButtons) {
+        visibility.setBit(i++, button->isVisible() && button->isEnabled());
+    }
+    return visibility;
+}
+
 //________________________________________________________________
 void Decoration::paint(QPainter *painter, const QRect &repaintRegion)
 {
+    KLASSY_TRACE_SCOPE("decoration", "Decoration::paint");
     m_painting = true;
 
     // TODO: optimize based on repaintRegion
@@ -1194,6 +1384,7 @@ void Decoration::calculateWindowAndTitleBarShapes(const bool windowShapeOnly)
 //________________________________________________________________
 void Decoration::paintTitleBar(QPainter *painter, const QRect &repaintRegion)
 {
+    KLASSY_TRACE_SCOPE("decoration", "Decoration::paintTitleBar");
     const auto c = client();
 
     if (!m_titleRect.intersects(repaintRegion)) {
@@ -1426,6 +1617,7 @@ QPair<QRect, Qt::Alignment> Decoration::captionRect() const
 //________________________________________________________________
 void Decoration::updateShadow(const bool forceUpdateCache, bool noCache, const bool isThinWindowOutlineOverride)
 {
+    KLASSY_TRACE_SCOPE("decoration", "Decoration::updateShadow");
     auto c = client();
 
     // if the decoration is painting, abandon setting the shadow.
@@ -1492,6 +1684,19 @@ void Decoration::updateShadow(const bool forceUpdateCache, bool noCache, const b
     if (!(*shadow)) { // only recreate the shadow if necessary
         QColor shadowColor = c->isActive() ? m_decorationColors->active()->shadow : m_decorationColors->inactive()->shadow;
         *shadow = createShadowObject(shadowColor, isThinWindowOutlineOverride);
+
+        if (!noCache) {
+            Statistics::self()->recordCacheMiss("shadow");
+            qint64 cachedBytes = 0;
+            for (const auto &cachedShadow : {g_sShadow, g_sShadowInactive}) {
+                if (cachedShadow) {
+                    cachedBytes += cachedShadow->shadow().sizeInBytes();
+                }
+            }
+            Statistics::self()->setCacheBytes("shadow", cachedBytes);
+        }
+    } else {
+        Statistics::self()->recordCacheHit("shadow");
     }
 
     setShadow(*shadow);
@@ -1500,6 +1705,7 @@ void Decoration::updateShadow(const bool forceUpdateCache, bool noCache, const b
 //________________________________________________________________
 std::shared_ptr<KDecoration2::DecorationShadow> Decoration::createShadowObject(QColor shadowColor, const bool isThinWindowOutlineOverride)
 {
+    KLASSY_TRACE_SCOPE("decoration", "Decoration::createShadowObject");
     auto c = client();
 
     // determine when a window outline does not need to be drawn (even when set to none, sometimes needs to be drawn if there is an animation)
@@ -1514,48 +1720,15 @@ std::shared_ptr<KDecoration2::DecorationShadow> Decoration::createShadowObject(Q
         return nullptr;
     }
 
-    const CompositeShadowParams params = lookupShadowParams(m_internalSettings->shadowSize());
-
-    const QSize boxSize =
-        BoxShadowRenderer::calculateMinimumBoxSize(params.shadow1.radius).expandedTo(BoxShadowRenderer::calculateMinimumBoxSize(params.shadow2.radius));
-
-    BoxShadowRenderer shadowRenderer;
+    const bool topCornersOnly = hasNoBorders() && !m_internalSettings->roundBottomCornersWhenNoBorders() && !c->isShaded();
+    const ShadowTexture shadowTexture = cachedShadowTexture(shadowColor, topCornersOnly);
+    const QRectF &innerRect = shadowTexture.innerRect;
 
-    shadowRenderer.setBorderRadius(m_scaledCornerRadius + 0.5);
-    shadowRenderer.setBoxSize(boxSize);
-    shadowRenderer.addShadow(params.shadow1.offset, params.shadow1.radius, ColorTools::alphaMix(shadowColor, params.shadow1.opacity));
-    shadowRenderer.addShadow(params.shadow2.offset, params.shadow2.radius, ColorTools::alphaMix(shadowColor, params.shadow2.opacity));
-
-    QImage shadowTexture = shadowRenderer.render();
-
-    QPainter painter(&shadowTexture);
+    // the outline is drawn onto a copy, leaving the cached texture untouched
+    QImage shadowImage = shadowTexture.texture;
+    QPainter painter(&shadowImage);
     painter.setRenderHint(QPainter::Antialiasing);
 
-    const QRect outerRect = shadowTexture.rect();
-
-    QRect boxRect(QPoint(0, 0), boxSize);
-    boxRect.moveCenter(outerRect.center());
-
-    // Mask out inner rect.
-    const QMargins padding = QMargins(boxRect.left() - outerRect.left() - Metrics::Decoration_Shadow_Overlap - params.offset.x(),
-                                      boxRect.top() - outerRect.top() - Metrics::Decoration_Shadow_Overlap - params.offset.y(),
-                                      outerRect.right() - boxRect.right() - Metrics::Decoration_Shadow_Overlap + params.offset.x(),
-                                      outerRect.bottom() - boxRect.bottom() - Metrics::Decoration_Shadow_Overlap + params.offset.y());
-    const QRectF innerRect = outerRect - padding;
-
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(Qt::black);
-    painter.setCompositionMode(QPainter::CompositionMode_DestinationOut);
-
-    QPainterPath roundedRectMask;
-    if (hasNoBorders() && !m_internalSettings->roundBottomCornersWhenNoBorders() && !c->isShaded()) {
-        roundedRectMask = GeometryTools::roundedPath(innerRect, CornersTop, m_scaledCornerRadius + 0.5);
-    } else {
-        roundedRectMask.addRoundedRect(innerRect, m_scaledCornerRadius + 0.5, m_scaledCornerRadius + 0.5);
-    }
-
-    painter.drawPath(roundedRectMask);
-
     // Draw Thin window outline
     if (!windowOutlineNone || isThinWindowOutlineOverride) {
         if (m_thinWindowOutline.isValid()) {
@@ -1601,7 +1774,7 @@ std::shared_ptr<KDecoration2::DecorationShadow> Decoration::createShadowObject(Q
             else
                 cornerRadius = m_scaledCornerRadius + outlineAdjustment; // else round corner slightly more to account for pen width
 
-            if (hasNoBorders() && !m_internalSettings->roundBottomCornersWhenNoBorders() && !c->isShaded()) {
+            if (topCornersOnly) {
                 outlinePath = GeometryTools::roundedPath(outlineRect, CornersTop, cornerRadius);
             } else {
                 outlinePath.addRoundedRect(outlineRect, cornerRadius, cornerRadius);
@@ -1613,12 +1786,74 @@ std::shared_ptr<KDecoration2::DecorationShadow> Decoration::createShadowObject(Q
     painter.end();
 
     auto ret = std::make_shared<KDecoration2::DecorationShadow>();
-    ret->setPadding(padding);
-    ret->setInnerShadowRect(QRect(outerRect.center(), QSize(1, 1)));
-    ret->setShadow(shadowTexture);
+    ret->setPadding(shadowTexture.padding);
+    ret->setInnerShadowRect(QRect(shadowImage.rect().center(), QSize(1, 1)));
+    ret->setShadow(shadowImage);
     return ret;
 }
 
+//________________________________________________________________
+ShadowTexture Decoration::cachedShadowTexture(const QColor &shadowColor, const bool topCornersOnly) const
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << m_internalSettings->shadowSize() << shadowColor << m_scaledCornerRadius << topCornersOnly;
+
+    if (const ShadowTexture *cached = g_shadowTextures.object(key)) {
+        Statistics::self()->recordCacheHit("shadowTexture");
+        return *cached;
+    }
+    Statistics::self()->recordCacheMiss("shadowTexture");
+
+    const CompositeShadowParams params = lookupShadowParams(m_internalSettings->shadowSize());
+
+    const QSize boxSize =
+        BoxShadowRenderer::calculateMinimumBoxSize(params.shadow1.radius).expandedTo(BoxShadowRenderer::calculateMinimumBoxSize(params.shadow2.radius));
+
+    BoxShadowRenderer shadowRenderer;
+
+    shadowRenderer.setBorderRadius(m_scaledCornerRadius + 0.5);
+    shadowRenderer.setBoxSize(boxSize);
+    shadowRenderer.addShadow(params.shadow1.offset, params.shadow1.radius, ColorTools::alphaMix(shadowColor, params.shadow1.opacity));
+    shadowRenderer.addShadow(params.shadow2.offset, params.shadow2.radius, ColorTools::alphaMix(shadowColor, params.shadow2.opacity));
+
+    ShadowTexture shadowTexture;
+    shadowTexture.texture = shadowRenderer.render();
+    Statistics::self()->increment("shadowRenders");
+
+    QPainter painter(&shadowTexture.texture);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const QRect outerRect = shadowTexture.texture.rect();
+
+    QRect boxRect(QPoint(0, 0), boxSize);
+    boxRect.moveCenter(outerRect.center());
+
+    // Mask out inner rect.
+    shadowTexture.padding = QMargins(boxRect.left() - outerRect.left() - Metrics::Decoration_Shadow_Overlap - params.offset.x(),
+                                     boxRect.top() - outerRect.top() - Metrics::Decoration_Shadow_Overlap - params.offset.y(),
+                                     outerRect.right() - boxRect.right() - Metrics::Decoration_Shadow_Overlap + params.offset.x(),
+                                     outerRect.bottom() - boxRect.bottom() - Metrics::Decoration_Shadow_Overlap + params.offset.y());
+    shadowTexture.innerRect = outerRect - shadowTexture.padding;
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::black);
+    painter.setCompositionMode(QPainter::CompositionMode_DestinationOut);
+
+    QPainterPath roundedRectMask;
+    if (topCornersOnly) {
+        roundedRectMask = GeometryTools::roundedPath(shadowTexture.innerRect, CornersTop, m_scaledCornerRadius + 0.5);
+    } else {
+        roundedRectMask.addRoundedRect(shadowTexture.innerRect, m_scaledCornerRadius + 0.5, m_scaledCornerRadius + 0.5);
+    }
+
+    painter.drawPath(roundedRectMask);
+    painter.end();
+
+    g_shadowTextures.insert(key, new ShadowTexture(shadowTexture));
+    return shadowTexture;
+}
+
 void Decoration::setThinWindowOutlineOverrideColor(const bool on, const QColor &color)
 {
     auto c = client();
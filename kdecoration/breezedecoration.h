@@ -10,6 +10,7 @@
 
 #include "breeze.h"
 
+#include "breezedecorationanimation.h"
 #include "breezesettings.h"
 #include "colortools.h"
 #include "decorationcolors.h"
@@ -19,10 +20,11 @@
 #include <KDecoration2/DecorationSettings>
 #include <KSharedConfig>
 
+#include <QBitArray>
+#include <QImage>
 #include <QPainterPath>
 #include <QPalette>
 #include <QVariant>
-#include <QVariantAnimation>
 
 #include <memory>
 
@@ -35,6 +37,9 @@ class DecorationButtonGroup;
 namespace Breeze
 {
 
+class GtkCsdButtonExporter;
+struct ShadowTexture;
+
 enum struct ButtonBackgroundType {
     Small,
     FullHeight,
@@ -44,6 +49,9 @@ class Decoration : public KDecoration2::Decoration
 {
     Q_OBJECT
 
+    friend class DecorationReconfigureQueue;
+    friend class DecorationBenchmark;
+
 public:
     //* constructor
     explicit Decoration(QObject *parent = nullptr, const QVariantList &args = QVariantList());
@@ -151,7 +159,7 @@ public:
         return m_rightButtons;
     }
 
-    QVariantAnimation *activeStateChangeAnimation()
+    DecorationAnimation *activeStateChangeAnimation()
     {
         return m_animation;
     }
@@ -161,6 +169,19 @@ public:
         return m_opacity;
     }
 
+    /**
+     * @brief Export every GTK client-side decoration button asset in one call, for kde-gtk-config and similar tools rather than painting
+     *        one standalone button state at a time. Invoke with QMetaObject::invokeMethod(decoration, "exportGtkCsdButtons", ...).
+     * @param directoryPath The directory to write "<button>-<state>[@<scale>].png" assets to
+     * @param buttonSize The size of each button in logical pixels
+     * @param scales The device pixel ratios to render at
+     * @return The number of files written, or -1 on error
+     */
+    Q_INVOKABLE int exportGtkCsdButtons(const QString &directoryPath, int buttonSize, const QList<qreal> &scales);
+
+    //* render the GTK client-side decoration button assets at one scale into a single atlas image, one row per button and one column per state
+    Q_INVOKABLE QImage renderGtkCsdButtonAtlas(int buttonSize, qreal scale);
+
 Q_SIGNALS:
     void reconfigured();
 
@@ -183,11 +204,14 @@ private Q_SLOTS:
     void generateDecorationColorsOnClientPaletteUpdate(const QPalette &clientPalette);
     void generateDecorationColorsOnDecorationColorSettingsUpdate(QByteArray uuid);
     void generateDecorationColorsOnSystemColorSettingsUpdate(QByteArray uuid);
+    void updateOnGlobalPaletteChange(QByteArray uuid);
+    void updateOnGlobalFontsChange();
     void recalculateBorders();
     void updateOpaque();
     void updateBlur();
     void updateButtonsGeometry();
     void updateButtonsGeometryDelayed();
+    void updateButtonsGeometryOnWidthChange();
     void updateTitleBar();
     void updateAnimationState();
     void updateShadowOnShadedChange()
@@ -200,13 +224,26 @@ private:
     //* return the rect in which caption will be drawn
     QPair<QRect, Qt::Alignment> captionRect() const;
 
-    void reconfigureMain(const bool noUpdateShadow = false);
+    /**
+     * @brief Reconfigures the decoration from the current settings
+     * @param noUpdateShadow Skip regenerating the shadow
+     * @param reloadConfig Reload klassyrc and kdeglobals first if a configuration change notification has invalidated the decoration template since they
+     *                     were last read; false when the DecorationReconfigureQueue has already reloaded them for a batch
+     */
+    void reconfigureMain(const bool noUpdateShadow = false, const bool reloadConfig = true);
+
+    //* forces the next reconfigureMain() to re-read the shared configuration; called on configuration change notifications rather than by each window map
+    static void invalidateDecorationTemplate();
     void updateDecorationColors(const QPalette &clientPalette, QByteArray uuid = "");
+    //* regenerate the colours from the already reloaded settings; called by the DecorationReconfigureQueue
+    void regenerateDecorationColors(QByteArray uuid);
     void createButtons();
     void calculateWindowAndTitleBarShapes(const bool windowShapeOnly = false);
     void paintTitleBar(QPainter *painter, const QRect &repaintRegion);
     void updateShadow(const bool forceUpdateCache = false, bool noCache = false, const bool isThinWindowOutlineOverride = false);
     std::shared_ptr<KDecoration2::DecorationShadow> createShadowObject(QColor shadowColor, const bool isThinWindowOutlineOverride = false);
+    //* the blurred and masked shadow without the thin window outline, rendered only when not already cached
+    ShadowTexture cachedShadowTexture(const QColor &shadowColor, const bool topCornersOnly) const;
     void setScaledCornerRadius();
 
     //*@name border size
@@ -232,6 +269,12 @@ private:
     //* calculates and sets m_thinWindowOutline
     void setThinWindowOutlineColor();
 
+    //* positions the right button group against the right edge of the decoration, using the padding from the last full button layout
+    void updateRightButtonsPosition();
+
+    //* visible and enabled state of each left then right button
+    QBitArray buttonsVisibility() const;
+
     void setGlobalLookAndFeelOptions(QString lookAndFeelPackageName);
 
     static KSharedConfig::Ptr s_kdeGlobalConfig;
@@ -242,15 +285,30 @@ private:
     //* Whether the paint() method is active
     bool m_painting = false;
 
+    //*@name state of the last full button layout, so that a change in width only needs to reposition the right buttons
+    //@{
+    bool m_buttonsLayoutValid = false;
+    bool m_buttonsLayoutRightEdge = false;
+    QBitArray m_buttonsLayoutVisibility;
+    //* whether there is a visible right button to position
+    bool m_rightButtonsPlaced = false;
+    int m_rightButtonsVPadding = 0;
+    //@}
+
     //* Object to return decoration palette colours
-    std::unique_ptr<DecorationColors> m_decorationColors;
+    std::shared_ptr<DecorationColors> m_decorationColors;
+    //* whether m_decorationColors is shared with other windows using the same client-specific colour scheme
+    bool m_decorationColorsPooled = false;
+
+    //* created on first GTK CSD button export, so that its buttons are reused by later exports
+    std::unique_ptr<GtkCsdButtonExporter> m_gtkCsdButtonExporter;
 
     //* active state change animation
-    QVariantAnimation *m_animation;
+    DecorationAnimation *m_animation;
     //* shadow animation
-    QVariantAnimation *m_shadowAnimation;
+    DecorationAnimation *m_shadowAnimation;
     //*window outline animation when "Colourize with highlighted button'a colour ticked"
-    QVariantAnimation *m_overrideOutlineFromButtonAnimation;
+    DecorationAnimation *m_overrideOutlineFromButtonAnimation;
 
     //* active state change animation opacity
     qreal m_opacity = 0;
@@ -0,0 +1,214 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "breezedecorationanimation.h"
+#include "statistics.h"
+
+namespace Breeze
+{
+
+DecorationAnimationScheduler *DecorationAnimationScheduler::s_self = nullptr;
+
+//________________________________________________________________
+DecorationAnimation::DecorationAnimation(KDecoration2::Decoration *decoration, QObject *parent)
+    : QObject(parent)
+    , m_decoration(decoration)
+{
+}
+
+//________________________________________________________________
+DecorationAnimation::~DecorationAnimation()
+{
+    if (m_state == QAbstractAnimation::Running) {
+        DecorationAnimationScheduler::self()->unregisterAnimation(this);
+    }
+}
+
+//________________________________________________________________
+qreal DecorationAnimation::currentValue() const
+{
+    if (m_duration <= 0) {
+        return m_direction == QAbstractAnimation::Forward ? 1.0 : 0.0;
+    }
+    return m_easingCurve.valueForProgress(qreal(m_currentTime) / qreal(m_duration));
+}
+
+//________________________________________________________________
+void DecorationAnimation::start()
+{
+    if (m_state == QAbstractAnimation::Running) {
+        return;
+    }
+
+    m_currentTime = (m_direction == QAbstractAnimation::Forward) ? 0 : m_duration;
+
+    if (m_duration <= 0) {
+        finish();
+        return;
+    }
+
+    m_state = QAbstractAnimation::Running;
+    DecorationAnimationScheduler::self()->registerAnimation(this);
+}
+
+//________________________________________________________________
+void DecorationAnimation::stop()
+{
+    if (m_state == QAbstractAnimation::Stopped) {
+        return;
+    }
+
+    m_state = QAbstractAnimation::Stopped;
+    DecorationAnimationScheduler::self()->unregisterAnimation(this);
+}
+
+//________________________________________________________________
+bool DecorationAnimation::advance(int elapsed)
+{
+    if (m_direction == QAbstractAnimation::Forward) {
+        m_currentTime = qMin(m_duration, m_currentTime + elapsed);
+    } else {
+        m_currentTime = qMax(0, m_currentTime - elapsed);
+    }
+
+    const bool atEnd = (m_direction == QAbstractAnimation::Forward) ? (m_currentTime >= m_duration) : (m_currentTime <= 0);
+    if (atEnd) {
+        finish();
+        return false;
+    }
+
+    Q_EMIT valueChanged(currentValue());
+    return true;
+}
+
+//________________________________________________________________
+void DecorationAnimation::finish()
+{
+    m_currentTime = (m_direction == QAbstractAnimation::Forward) ? m_duration : 0;
+
+    // as with QVariantAnimation the final value is emitted while the animation is still in the running state
+    m_state = QAbstractAnimation::Running;
+    Q_EMIT valueChanged(currentValue());
+    stop();
+    Q_EMIT finished();
+}
+
+//________________________________________________________________
+DecorationAnimationScheduler *DecorationAnimationScheduler::self()
+{
+    // deliberately never deleted, so that animations destroyed during plugin teardown can still unregister
+    if (!s_self) {
+        s_self = new DecorationAnimationScheduler();
+    }
+
+    return s_self;
+}
+
+//________________________________________________________________
+DecorationAnimationScheduler::DecorationAnimationScheduler()
+{
+    m_timer.setInterval(s_tickInterval);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &DecorationAnimationScheduler::tick);
+}
+
+//________________________________________________________________
+void DecorationAnimationScheduler::registerAnimation(DecorationAnimation *animation)
+{
+    if (!m_running.contains(animation)) {
+        m_running.append(animation);
+    }
+    Statistics::self()->setGauge("activeAnimations", m_running.count());
+
+    if (!m_timer.isActive()) {
+        m_clock.start();
+        m_lastTick = 0;
+        m_timer.start();
+    }
+}
+
+//________________________________________________________________
+void DecorationAnimationScheduler::unregisterAnimation(DecorationAnimation *animation)
+{
+    m_running.removeOne(animation);
+    Statistics::self()->setGauge("activeAnimations", m_running.count());
+
+    // the timer is stopped at the end of the tick if called from within one
+    if (m_running.isEmpty() && !m_ticking) {
+        m_timer.stop();
+    }
+}
+
+//________________________________________________________________
+void DecorationAnimationScheduler::tick()
+{
+    const qint64 now = m_clock.elapsed();
+    const int elapsed = int(now - m_lastTick);
+    m_lastTick = now;
+
+    m_ticking = true;
+
+    // iterate over a copy as handlers may start, stop or destroy animations
+    const QList<DecorationAnimation *> running = m_running;
+    for (DecorationAnimation *animation : running) {
+        if (!m_running.contains(animation)) { // stopped or destroyed earlier in this tick
+            continue;
+        }
+
+        // nothing visible to animate, so jump straight to the final state
+        KDecoration2::Decoration *decoration = animation->decoration();
+        if (!decoration || decoration->size().isEmpty()) {
+            animation->finish();
+            continue;
+        }
+
+        animation->advance(elapsed);
+    }
+
+    m_ticking = false;
+
+    flushUpdates();
+
+    if (m_running.isEmpty()) {
+        m_timer.stop();
+    }
+}
+
+//________________________________________________________________
+void DecorationAnimationScheduler::scheduleUpdate(KDecoration2::Decoration *decoration, const QRect &rect)
+{
+    if (!decoration) {
+        return;
+    }
+
+    const QRect updateRect = rect.isNull() ? decoration->rect() : rect;
+
+    if (!m_ticking) {
+        decoration->update(updateRect);
+        return;
+    }
+
+    for (auto &pendingUpdate : m_pendingUpdates) {
+        if (pendingUpdate.first == decoration) {
+            pendingUpdate.second += updateRect;
+            return;
+        }
+    }
+    m_pendingUpdates.append({QPointer<KDecoration2::Decoration>(decoration), QRegion(updateRect)});
+}
+
+//________________________________________________________________
+void DecorationAnimationScheduler::flushUpdates()
+{
+    const auto pendingUpdates = std::exchange(m_pendingUpdates, {});
+    for (const auto &pendingUpdate : pendingUpdates) {
+        if (pendingUpdate.first) {
+            pendingUpdate.first->update(pendingUpdate.second.boundingRect());
+        }
+    }
+}
+
+}
@@ -0,0 +1,165 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <KDecoration2/Decoration>
+
+#include <QAbstractAnimation>
+#include <QEasingCurve>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QRegion>
+#include <QTimer>
+
+#include <utility>
+
+namespace Breeze
+{
+
+/**
+ * @brief A 0.0 to 1.0 animation which is advanced by the shared DecorationAnimationScheduler rather than by its own timer.
+ *        Mirrors the subset of the QVariantAnimation API used by the decoration and its buttons.
+ */
+class DecorationAnimation : public QObject
+{
+    Q_OBJECT
+
+public:
+    //* constructor
+    explicit DecorationAnimation(KDecoration2::Decoration *decoration, QObject *parent = nullptr);
+
+    //* destructor
+    ~DecorationAnimation() override;
+
+    void setDuration(int msecs)
+    {
+        m_duration = qMax(0, msecs);
+        m_currentTime = qBound(0, m_currentTime, m_duration);
+    }
+
+    int duration() const
+    {
+        return m_duration;
+    }
+
+    void setDirection(QAbstractAnimation::Direction direction)
+    {
+        m_direction = direction;
+    }
+
+    QAbstractAnimation::Direction direction() const
+    {
+        return m_direction;
+    }
+
+    void setEasingCurve(const QEasingCurve &easingCurve)
+    {
+        m_easingCurve = easingCurve;
+    }
+
+    QAbstractAnimation::State state() const
+    {
+        return m_state;
+    }
+
+    //* eased value of the animation in the range 0.0 to 1.0
+    qreal currentValue() const;
+
+    //* the decoration whose repaints this animation drives
+    KDecoration2::Decoration *decoration() const
+    {
+        return m_decoration.data();
+    }
+
+public Q_SLOTS:
+    //* start from the beginning of the current direction (does nothing if already running)
+    void start();
+
+    //* stop without emitting a final value
+    void stop();
+
+Q_SIGNALS:
+    void valueChanged(qreal value);
+    void finished();
+
+private:
+    friend class DecorationAnimationScheduler;
+
+    //* advance the animation by the given number of milliseconds, returns false once the animation has finished
+    bool advance(int elapsed);
+
+    //* jump straight to the end value of the current direction
+    void finish();
+
+    QPointer<KDecoration2::Decoration> m_decoration;
+    QEasingCurve m_easingCurve = QEasingCurve::Linear;
+    QAbstractAnimation::Direction m_direction = QAbstractAnimation::Forward;
+    QAbstractAnimation::State m_state = QAbstractAnimation::Stopped;
+    int m_duration = 250;
+    int m_currentTime = 0;
+};
+
+/**
+ * @brief Advances every running Klassy decoration animation from a single timer tick and coalesces the resulting repaints,
+ *        so that only one update() per decoration is issued per tick rather than one per animation.
+ *        Animations of decorations which have no visible area are completed immediately rather than animated.
+ */
+class DecorationAnimationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    //* singleton
+    static DecorationAnimationScheduler *self();
+
+    /**
+     * @brief Request a repaint of the given decoration. Inside a scheduler tick the request is merged with any other requests for the same decoration
+     *        and issued once at the end of the tick; outside a tick the decoration is updated immediately.
+     * @param decoration The decoration to repaint
+     * @param rect The area to repaint in decoration co-ordinates; a null rect repaints the whole decoration
+     */
+    void scheduleUpdate(KDecoration2::Decoration *decoration, const QRect &rect = QRect());
+
+    //* number of animations currently being advanced
+    int runningAnimationCount() const
+    {
+        return m_running.count();
+    }
+
+private Q_SLOTS:
+    void tick();
+
+private:
+    friend class DecorationAnimation;
+
+    //* constructor
+    DecorationAnimationScheduler();
+
+    void registerAnimation(DecorationAnimation *animation);
+    void unregisterAnimation(DecorationAnimation *animation);
+    void flushUpdates();
+
+    //* interval between ticks, matching a 60Hz refresh
+    static constexpr int s_tickInterval = 16;
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastTick = 0;
+    bool m_ticking = false;
+
+    QList<DecorationAnimation *> m_running;
+
+    //* repaint areas accumulated during a tick, one entry per decoration
+    QList<std::pair<QPointer<KDecoration2::Decoration>, QRegion>> m_pendingUpdates;
+
+    //* singleton
+    static DecorationAnimationScheduler *s_self;
+};
+
+}
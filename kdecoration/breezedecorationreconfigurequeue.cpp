@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "breezedecorationreconfigurequeue.h"
+#include "breezedecoration.h"
+#include "breezesettingsprovider.h"
+#include "statistics.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <utility>
+
+namespace Breeze
+{
+
+DecorationReconfigureQueue *DecorationReconfigureQueue::s_self = nullptr;
+
+//________________________________________________________________
+DecorationReconfigureQueue *DecorationReconfigureQueue::self()
+{
+    if (!s_self) {
+        s_self = new DecorationReconfigureQueue();
+    }
+
+    return s_self;
+}
+
+//________________________________________________________________
+void DecorationReconfigureQueue::schedule(Decoration *decoration)
+{
+    if (!decoration) {
+        return;
+    }
+
+    for (const auto &queued : std::as_const(m_queued)) {
+        if (queued == decoration) {
+            return;
+        }
+    }
+    m_queued.append(QPointer<Decoration>(decoration));
+    scheduleProcess();
+}
+
+//________________________________________________________________
+void DecorationReconfigureQueue::scheduleColors(Decoration *decoration, const QByteArray &uuid)
+{
+    if (!decoration) {
+        return;
+    }
+
+    for (auto &queued : m_queuedColors) {
+        if (queued.decoration == decoration) {
+            queued.uuid = uuid;
+            return;
+        }
+    }
+    m_queuedColors.append({QPointer<Decoration>(decoration), uuid});
+    scheduleProcess();
+}
+
+//________________________________________________________________
+void DecorationReconfigureQueue::scheduleProcess()
+{
+    // everything queued follows a configuration change notification, so a window mapped before the pass must not adopt the old decoration template
+    Decoration::invalidateDecorationTemplate();
+
+    if (!m_processScheduled) {
+        m_processScheduled = true;
+        QTimer::singleShot(0, this, &DecorationReconfigureQueue::process);
+    }
+}
+
+//________________________________________________________________
+void DecorationReconfigureQueue::process()
+{
+    m_processScheduled = false;
+    const auto queuedColors = std::exchange(m_queuedColors, {});
+    const auto queued = std::exchange(m_queued, {});
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // the shared configuration is reloaded once for the whole pass
+    SettingsProvider::self()->reconfigure();
+    Decoration::s_kdeGlobalConfig->reparseConfiguration();
+    Decoration::invalidateDecorationTemplate();
+
+    int recolored = 0;
+    for (const auto &queuedColor : queuedColors) {
+        if (!queuedColor.decoration) { // destroyed since being queued
+            continue;
+        }
+
+        queuedColor.decoration->regenerateDecorationColors(queuedColor.uuid);
+        recolored++;
+    }
+
+    int processed = 0;
+    for (const auto &decoration : queued) {
+        if (!decoration) { // destroyed since being queued
+            continue;
+        }
+
+        // the colour, shadow and layout caches shared between decorations are only regenerated by the first decoration whose inputs differ
+        decoration->reconfigureMain(false, false);
+        decoration->updateButtonsGeometry();
+        processed++;
+    }
+
+    Statistics::self()->increment("reconfigurePasses");
+    Statistics::self()->increment("reconfiguredDecorations", processed);
+    Statistics::self()->increment("recoloredDecorations", recolored);
+    Statistics::self()->recordDuration("reconfigurePass", timer.nsecsElapsed());
+
+#if KLASSY_DECORATION_DEBUG_MODE
+    qDebug() << "klassy: recolored" << recolored << "and reconfigured" << processed << "decorations in" << timer.elapsed() << "ms";
+#endif
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+namespace Breeze
+{
+
+class Decoration;
+
+/**
+ * @brief Collects the decorations which need their colours regenerated or a full reconfiguration, and processes them all in a single deferred pass,
+ *        so that a settings change reloads klassyrc and kdeglobals once rather than once per decoration.
+ *        Within the pass, each decoration's colours are regenerated first, then its reconfigure and button layout run back to back.
+ */
+class DecorationReconfigureQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    //* singleton
+    static DecorationReconfigureQueue *self();
+
+    //* queue a full reconfiguration of the given decoration for the next pass; queueing a decoration more than once has no further effect
+    void schedule(Decoration *decoration);
+
+    //* queue a regeneration of the given decoration's colours for the next pass, identified by \p uuid so that pooled colours are only regenerated once
+    void scheduleColors(Decoration *decoration, const QByteArray &uuid);
+
+private Q_SLOTS:
+    void process();
+
+private:
+    //* constructor
+    DecorationReconfigureQueue() = default;
+
+    //* run process() once the event loop is next idle, if not already scheduled
+    void scheduleProcess();
+
+    struct QueuedColors {
+        QPointer<Decoration> decoration;
+        QByteArray uuid;
+    };
+
+    QList<QueuedColors> m_queuedColors;
+    QList<QPointer<Decoration>> m_queued;
+    bool m_processScheduled = false;
+
+    //* singleton
+    static DecorationReconfigureQueue *s_self;
+};
+
+}
@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "breezegtkcsdbuttonexporter.h"
+#include "breezedecoration.h"
+#include "tracing.h"
+
+#include <QDir>
+#include <QPainter>
+#include <QStringBuilder>
+
+namespace Breeze
+{
+
+const QList<GtkCsdButtonExporter::ButtonAsset> GtkCsdButtonExporter::s_buttonAssets{
+    {KDecoration2::DecorationButtonType::Close, false, QStringLiteral("close")},
+    {KDecoration2::DecorationButtonType::Maximize, false, QStringLiteral("maximize")},
+    {KDecoration2::DecorationButtonType::Maximize, true, QStringLiteral("maximized")},
+    {KDecoration2::DecorationButtonType::Minimize, false, QStringLiteral("minimize")},
+};
+
+const QList<GtkCsdButtonExporter::StateAsset> GtkCsdButtonExporter::s_stateAssets{
+    {{true, false, false}, QStringLiteral("normal")},
+    {{true, true, false}, QStringLiteral("hover")},
+    {{true, true, true}, QStringLiteral("active")},
+    {{false, false, false}, QStringLiteral("backdrop-normal")},
+    {{false, true, false}, QStringLiteral("backdrop-hover")},
+    {{false, true, true}, QStringLiteral("backdrop-active")},
+};
+
+//________________________________________________________________
+GtkCsdButtonExporter::GtkCsdButtonExporter(Decoration *decoration)
+    : m_decoration(decoration)
+{
+    if (!m_decoration) {
+        return;
+    }
+
+    // a Maximize button is created for each of the maximize and maximized assets, as the checked state is kept on the button
+    for (const ButtonAsset &buttonAsset : s_buttonAssets) {
+        auto button = std::make_unique<Button>(nullptr, QVariantList{QVariant::fromValue(buttonAsset.type), QVariant::fromValue(m_decoration)});
+        if (buttonAsset.checked) {
+            button->setCheckable(true);
+            button->setChecked(true);
+        }
+        m_buttons.push_back(std::move(button));
+    }
+}
+
+//________________________________________________________________
+GtkCsdButtonExporter::~GtkCsdButtonExporter() = default;
+
+//________________________________________________________________
+QStringList GtkCsdButtonExporter::assetNames()
+{
+    QStringList names;
+    for (const ButtonAsset &buttonAsset : s_buttonAssets) {
+        for (const StateAsset &stateAsset : s_stateAssets) {
+            names.append(buttonAsset.name % QStringLiteral("-") % stateAsset.name);
+        }
+    }
+    return names;
+}
+
+//________________________________________________________________
+QImage GtkCsdButtonExporter::renderAtlas(int buttonSize, qreal scale)
+{
+    KLASSY_TRACE_SCOPE_ARG("decoration", "GtkCsdButtonExporter::renderAtlas", "scale", scale);
+    if (!m_decoration || buttonSize <= 0 || scale <= 0) {
+        return QImage();
+    }
+
+    const int scaledButtonSize = qRound(buttonSize * scale);
+    QImage atlas(scaledButtonSize * s_stateAssets.count(), scaledButtonSize * s_buttonAssets.count(), QImage::Format_ARGB32_Premultiplied);
+    atlas.setDevicePixelRatio(scale);
+    atlas.fill(Qt::transparent);
+
+    // a single painter for every asset at this scale
+    QPainter painter(&atlas);
+    const QRect buttonGeometry(0, 0, buttonSize, buttonSize);
+    for (int row = 0; row < int(m_buttons.size()); row++) {
+        Button *button = m_buttons[row].get();
+        button->setGeometry(buttonGeometry);
+
+        for (int column = 0; column < s_stateAssets.count(); column++) {
+            button->setExportState(s_stateAssets.at(column).state);
+
+            painter.save();
+            // translate in logical pixels, aligned to whole device pixels
+            painter.translate(QPointF(column * scaledButtonSize, row * scaledButtonSize) / scale);
+            button->paint(&painter, buttonGeometry);
+            painter.restore();
+        }
+    }
+    painter.end();
+
+    return atlas;
+}
+
+//________________________________________________________________
+int GtkCsdButtonExporter::exportToDirectory(const QString &directoryPath, int buttonSize, const QList<qreal> &scales)
+{
+    KLASSY_TRACE_SCOPE("decoration", "GtkCsdButtonExporter::exportToDirectory");
+    if (!m_decoration || !QDir().mkpath(directoryPath)) {
+        return -1;
+    }
+
+    const QStringList names = assetNames();
+    int filesWritten = 0;
+    for (const qreal scale : scales) {
+        const QImage atlas = renderAtlas(buttonSize, scale);
+        if (atlas.isNull()) {
+            return -1;
+        }
+
+        const QString suffix = qFuzzyCompare(scale, 1.0) ? QStringLiteral(".png") : QStringLiteral("@") % QString::number(scale) % QStringLiteral(".png");
+        const int scaledButtonSize = qRound(buttonSize * scale);
+        for (int i = 0; i < names.count(); i++) {
+            const int row = i / s_stateAssets.count();
+            const int column = i % s_stateAssets.count();
+            QImage asset = atlas.copy(column * scaledButtonSize, row * scaledButtonSize, scaledButtonSize, scaledButtonSize);
+            if (!asset.save(directoryPath % QStringLiteral("/") % names.at(i) % suffix)) {
+                return -1;
+            }
+            filesWritten++;
+        }
+    }
+
+    return filesWritten;
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include "breezebutton.h"
+
+#include <QImage>
+#include <QList>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+namespace Breeze
+{
+
+class Decoration;
+
+/**
+ * @brief Renders every GTK client-side decoration button asset (button × state × scale) for a decoration in a single call,
+ *        instead of the caller painting one standalone button state at a time.
+ *        The decoration's palette is generated once and the same standalone buttons are reused for every asset.
+ */
+class GtkCsdButtonExporter
+{
+public:
+    //* constructor
+    explicit GtkCsdButtonExporter(Decoration *decoration);
+
+    //* destructor
+    ~GtkCsdButtonExporter();
+
+    /**
+     * @brief Render every asset at one scale into a single image, one row per button and one column per state, in the order of assetNames()
+     * @param buttonSize The size of each button in logical pixels
+     * @param scale The device pixel ratio to render at
+     */
+    QImage renderAtlas(int buttonSize, qreal scale);
+
+    /**
+     * @brief Write every asset at every scale to the given directory as "<button>-<state>.png", with "@<scale>" appended for scales other than 1
+     * @param directoryPath The directory to write to, which is created if necessary
+     * @param buttonSize The size of each button in logical pixels
+     * @param scales The device pixel ratios to render at
+     * @return The number of files written, or -1 on error
+     */
+    int exportToDirectory(const QString &directoryPath, int buttonSize, const QList<qreal> &scales);
+
+    //* the "<button>-<state>" asset names in atlas order
+    static QStringList assetNames();
+
+private:
+    struct ButtonAsset {
+        KDecoration2::DecorationButtonType type;
+        bool checked;
+        QString name;
+    };
+
+    struct StateAsset {
+        Button::ExportState state;
+        QString name;
+    };
+
+    //* the buttons which GTK header bars use
+    static const QList<ButtonAsset> s_buttonAssets;
+
+    //* the button states which GTK themes style
+    static const QList<StateAsset> s_stateAssets;
+
+    Decoration *m_decoration;
+
+    //* one standalone button per button type, reused for each state and scale
+    std::vector<std::unique_ptr<Button>> m_buttons;
+};
+
+}
@@ -7,8 +7,10 @@
 
 #include "breezesettingsprovider.h"
 #include "dbusmessages.h"
+#include "decorationbuttoncolors.h"
 #include "decorationexceptionlist.h"
 #include "presetsmodel.h"
+#include "tracing.h"
 
 #include <QRegularExpression>
 #include <QTextStream>
@@ -48,6 +50,9 @@ void SettingsProvider::reconfigure()
 {
     m_defaultSettings->load();
 
+    // decode the button override colour JSON once here, rather than in every palette generation
+    DecorationButtonPalette::decodeButtonOverrideColorSettings(m_defaultSettings);
+
     DecorationExceptionList exceptions;
     exceptions.readConfig(m_config);
     m_exceptions = exceptions.getDefault();
@@ -57,6 +62,7 @@ void SettingsProvider::reconfigure()
 //__________________________________________________________________
 InternalSettingsPtr SettingsProvider::internalSettings(Decoration *decoration)
 {
+    KLASSY_TRACE_SCOPE("decoration", "SettingsProvider::internalSettings");
     // get the client
     auto client = decoration->client();
 
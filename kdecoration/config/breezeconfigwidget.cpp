@@ -13,9 +13,11 @@
 #include "decorationexceptionlist.h"
 #include "presetsmodel.h"
 #include "renderdecorationbuttonicon.h"
+#include "settingssnapshot.h"
 
 #include <KLocalizedString>
 
+#include <QDataStream>
 #include <QIcon>
 #include <QRegularExpression>
 #include <QScreen>
@@ -61,6 +63,7 @@ ConfigWidget::ConfigWidget(QObject *parent, const KPluginMetaData &data, const Q
 
     // configuration
     m_ui.setupUi(widget());
+    m_windowControlPreviewRenderer = new PreviewRenderer(this);
 
     m_ui.defaultExceptions->setKConfig(m_configuration, m_presetsConfiguration);
     m_ui.exceptions->setKConfig(m_configuration, m_presetsConfiguration);
@@ -314,6 +317,7 @@ void ConfigWidget::saveMain(QString saveAsPresetName)
         m_presetsConfiguration->sync();
     }
 
+    SettingsSnapshot::write();
     DBusMessages::updateDecorationColorCache();
     // needed to tell kwin to reload when running from external kcmshell
     DBusMessages::kwinReloadConfig();
@@ -659,29 +663,50 @@ void ConfigWidget::updateWindowControlPreviewIcons()
 {
     QSize size(115, 72);
     m_ui.buttonIconStyle->setIconSize(size);
-
-    for (int i = 0; i < InternalSettings::EnumButtonIconStyle::COUNT; i++) {
-        if (i != static_cast<int>(InternalSettings::EnumButtonIconStyle::StyleSystemIconTheme)) {
-            generateWindowControlPreviewIcon(size, static_cast<InternalSettings::EnumButtonIconStyle::type>(i));
-        } else {
-            m_ui.buttonIconStyle->setItemIcon(static_cast<int>(InternalSettings::EnumButtonIconStyle::StyleSystemIconTheme),
-                                              QIcon::fromTheme(QStringLiteral("preferences-desktop-icons")));
-        }
-    }
+    m_ui.buttonIconStyle->setItemIcon(static_cast<int>(InternalSettings::EnumButtonIconStyle::StyleSystemIconTheme),
+                                      QIcon::fromTheme(QStringLiteral("preferences-desktop-icons")));
+
+    const qreal dpr = widget()->devicePixelRatioF();
+    const bool boldIcons = (m_ui.boldButtonIcons->currentIndex() == InternalSettings::EnumBoldButtonIcons::BoldIconsBold
+                            || (m_ui.boldButtonIcons->currentIndex() == InternalSettings::EnumBoldButtonIcons::BoldIconsHiDpiOnly && dpr >= 1.2));
+
+    // the previews depend only upon the scale and boldness, so toggling these back and forth is served from the cache
+    QByteArray key;
+    QDataStream(&key, QIODevice::WriteOnly) << size << dpr << boldIcons;
+
+    m_windowControlPreviewRenderer->request(
+        key,
+        [size, dpr, boldIcons](const std::atomic<bool> &cancelled) {
+            PreviewImages previews;
+            for (int i = 0; i < InternalSettings::EnumButtonIconStyle::COUNT; i++) {
+                if (i == static_cast<int>(InternalSettings::EnumButtonIconStyle::StyleSystemIconTheme)) {
+                    continue;
+                }
+                if (cancelled) {
+                    return PreviewImages();
+                }
+                previews.append({0, i, renderWindowControlPreviewIcon(size, dpr, boldIcons, static_cast<InternalSettings::EnumButtonIconStyle::type>(i))});
+            }
+            return previews;
+        },
+        [this](const PreviewImages &previews) {
+            for (const PreviewImage &preview : previews) {
+                m_ui.buttonIconStyle->setItemIcon(preview.index, QIcon(QPixmap::fromImage(preview.image)));
+            }
+        });
 }
 
-void ConfigWidget::generateWindowControlPreviewIcon(QSize size, InternalSettings::EnumButtonIconStyle::type iconStyle)
+QImage ConfigWidget::renderWindowControlPreviewIcon(QSize size, qreal dpr, bool boldIcons, InternalSettings::EnumButtonIconStyle::type iconStyle)
 {
-    qreal dpr = widget()->devicePixelRatioF();
     QSize sizeScaled(qRound(size.width() * dpr), qRound(size.height() * dpr));
-    QPixmap pixmap(sizeScaled);
-    pixmap.setDevicePixelRatio(dpr);
+    QImage image(sizeScaled, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
 
-    pixmap.fill(QColor("#eeeff0"));
+    image.fill(QColor("#eeeff0"));
 
     QRect windowRect(0, size.height() / 2, size.width(), size.height() / 2);
 
-    std::unique_ptr<QPainter> painter = std::make_unique<QPainter>(&pixmap);
+    std::unique_ptr<QPainter> painter = std::make_unique<QPainter>(&image);
     painter->setPen(Qt::NoPen);
     painter->setBrush(QColor("#a3a6a9"));
     painter->drawRect(windowRect);
@@ -693,8 +718,6 @@ void ConfigWidget::generateWindowControlPreviewIcon(QSize size, InternalSettings
     int floatingButtonTop = (size.height() * 3 / 4) - (iconSize.height() * 3 / 4);
     int iconSpacing = 14;
 
-    bool boldIcons = (m_ui.boldButtonIcons->currentIndex() == InternalSettings::EnumBoldButtonIcons::BoldIconsBold
-                      || (m_ui.boldButtonIcons->currentIndex() == InternalSettings::EnumBoldButtonIcons::BoldIconsHiDpiOnly && dpr >= 1.2));
     auto internalSettings = InternalSettingsPtr(new InternalSettings());
     internalSettings->setButtonIconStyle(iconStyle);
 
@@ -763,9 +786,8 @@ void ConfigWidget::generateWindowControlPreviewIcon(QSize size, InternalSettings
     iconRenderer->renderIcon(DecorationButtonType::Close, false);
     painter->restore();
 
-    QIcon icon(pixmap);
-
-    m_ui.buttonIconStyle->setItemIcon(iconStyle, icon);
+    painter.reset();
+    return image;
 }
 
 bool ConfigWidget::eventFilter(QObject *obj, QEvent *ev)
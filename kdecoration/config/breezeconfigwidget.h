@@ -17,6 +17,7 @@
 #include "buttoncolors.h"
 #include "buttonsizing.h"
 #include "loadpreset.h"
+#include "previewrenderer.h"
 #include "shadowstyle.h"
 #include "systemicongeneration.h"
 #include "titlebaropacity.h"
@@ -157,7 +158,11 @@ private:
 
     void importBundledPresets();
     void updateIcons();
-    void generateWindowControlPreviewIcon(QSize size, InternalSettings::EnumButtonIconStyle::type iconStyle);
+
+    //* renders the preview of an icon style for the buttonIconStyle combo box; runs on a worker thread
+    static QImage renderWindowControlPreviewIcon(QSize size, qreal dpr, bool boldIcons, InternalSettings::EnumButtonIconStyle::type iconStyle);
+
+    PreviewRenderer *m_windowControlPreviewRenderer;
 };
 
 }
@@ -8,6 +8,7 @@
 #include "breezeconfigwidget.h"
 #include "dbusmessages.h"
 #include "presetsmodel.h"
+#include "settingssnapshot.h"
 #include <QPushButton>
 
 namespace Breeze
@@ -567,6 +568,7 @@ void ButtonBehaviour::save(const bool reloadKwinConfig)
     Q_EMIT saved();
 
     if (reloadKwinConfig) {
+        SettingsSnapshot::write();
         DBusMessages::updateDecorationColorCache();
         DBusMessages::kwinReloadConfig();
         // DBusMessages::kstyleReloadDecorationConfig(); //should reload anyway
@@ -9,10 +9,14 @@
 #include "dbusmessages.h"
 #include "presetsmodel.h"
 #include "renderdecorationbuttonicon.h"
+#include "settingssnapshot.h"
 #include "systemicontheme.h"
 #include <KColorCombo>
 #include <KColorUtils>
 #include <QCheckBox>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
 #include <QHBoxLayout>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -22,6 +26,7 @@
 #include <QPushButton>
 #include <QSlider>
 #include <QSpinBox>
+#include <QStandardPaths>
 #include <QWindow>
 #include <memory>
 
@@ -37,6 +42,7 @@ ButtonColors::ButtonColors(KSharedConfig::Ptr config, KSharedConfig::Ptr presets
 {
     m_ui->setupUi(this);
     m_internalSettings = InternalSettingsPtr(new InternalSettings());
+    m_palettePreviewRenderer = new PreviewRenderer(this);
     getButtonsOrderFromKwinConfig();
 
     m_ui->activeOverrideGroupBox->setVisible(false);
@@ -672,6 +678,7 @@ void ButtonColors::save(const bool reloadKwinConfig)
     setChanged(false);
 
     if (reloadKwinConfig) {
+        SettingsSnapshot::write();
         DBusMessages::updateDecorationColorCache();
         DBusMessages::kwinReloadConfig();
         // DBusMessages::kstyleReloadDecorationConfig(); //should reload anyway
@@ -1560,28 +1567,100 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
     auto uiSetButtonBackgroundOpacity = active ? m_ui->buttonBackgroundOpacityActive : m_ui->buttonBackgroundOpacityInactive;
     auto uiUseHoverAccentActive = active ? m_ui->useHoverAccentActive : m_ui->useHoverAccentInactive;
 
-    InternalSettingsPtr temporaryColorSettings =
-        InternalSettingsPtr(new InternalSettings); // temporary settings that reflect the UI, only to instantly update the colours displayed in the UI
+    uiButtonBackgroundColors->setIconSize(QSize(32, 32));
+    uiButtonIconColors->setIconSize(QSize(24, 24));
+    uiCloseButtonIconColor->setIconSize(QSize(16, 16));
+
+    // snapshot the UI state, so that the previews can be rendered on a worker thread
+    ButtonPalettePreviewState state;
+    state.active = active;
+    state.palette = QApplication::palette();
+    state.systemTitleBarTextActive = m_systemTitleBarTextActive;
+    state.systemTitlebarBackgroundActive = m_systemTitlebarBackgroundActive;
+    state.systemTitleBarTextInactive = m_systemTitleBarTextInactive;
+    state.systemTitlebarBackgroundInactive = m_systemTitlebarBackgroundInactive;
+    state.closeButtonIconColor = convertCloseButtonIconColorUiToSettingsIndex(active, uiCloseButtonIconColor->currentIndex());
+    state.negativeCloseBackgroundHoverPress = uiNegativeCloseBackgroundHoverPress->isChecked();
+    state.onPoorIconContrast = uiSetOnPoorIconContrast->currentIndex();
+    state.adjustBackgroundColorOnPoorContrast = uiSetAdjustBackgroundColorOnPoorContrast->isChecked();
+    state.buttonIconOpacity = uiSetButtonIconOpacity->value();
+    state.buttonBackgroundOpacity = uiSetButtonBackgroundOpacity->value();
+    state.useHoverAccent = uiUseHoverAccentActive->isChecked();
+    state.buttonBackgroundColors = uiButtonBackgroundColors->currentIndex();
+    state.buttonIconColors = uiButtonIconColors->currentIndex();
+    for (int i = 0; i < InternalSettings::EnumCloseButtonIconColor::COUNT; i++) {
+        state.closeButtonIconColorUiIndexes.insert(i, convertCloseButtonIconColorSettingsToUiIndex(active, i));
+    }
+    state.visibleButtonsOrder = m_visibleButtonsOrder;
+    // the rest of the settings are loaded from klassyrc by the render, so changes saved by this or another dialog must give a new key
+    const QFileInfo configFileInfo(QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) + QStringLiteral("/klassy/klassyrc"));
+    state.configFileModified = configFileInfo.lastModified().toMSecsSinceEpoch();
+    state.configFileSize = configFileInfo.size();
+
+    m_palettePreviewRenderer->request(
+        state.key(),
+        [state](const std::atomic<bool> &cancelled) {
+            return renderButtonPalettePreviews(state, cancelled);
+        },
+        [this, active](const PreviewImages &previews) {
+            for (const PreviewImage &preview : previews) {
+                QComboBox *comboBox = nullptr;
+                switch (preview.target) {
+                case ButtonBackgroundColorsPreview:
+                    comboBox = active ? m_ui->buttonBackgroundColorsActive : m_ui->buttonBackgroundColorsInactive;
+                    break;
+                case ButtonIconColorsPreview:
+                    comboBox = active ? m_ui->buttonIconColorsActive : m_ui->buttonIconColorsInactive;
+                    break;
+                case CloseButtonIconColorPreview:
+                default:
+                    comboBox = active ? m_ui->closeButtonIconColorActive : m_ui->closeButtonIconColorInactive;
+                    break;
+                }
+                comboBox->setItemIcon(preview.index, QIcon(QPixmap::fromImage(preview.image)));
+            }
+        });
+}
+
+QByteArray ButtonColors::ButtonPalettePreviewState::key() const
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << active << palette << systemTitleBarTextActive << systemTitlebarBackgroundActive << systemTitleBarTextInactive << systemTitlebarBackgroundInactive
+           << closeButtonIconColor << negativeCloseBackgroundHoverPress << onPoorIconContrast << adjustBackgroundColorOnPoorContrast << buttonIconOpacity
+           << buttonBackgroundOpacity << useHoverAccent << buttonBackgroundColors << buttonIconColors << closeButtonIconColorUiIndexes << configFileModified
+           << configFileSize;
+    for (const DecorationButtonType type : visibleButtonsOrder) {
+        stream << static_cast<int>(type);
+    }
+    return key;
+}
+
+PreviewImages ButtonColors::renderButtonPalettePreviews(const ButtonPalettePreviewState &state, const std::atomic<bool> &cancelled)
+{
+    const bool active = state.active;
+    PreviewImages previews;
+
+    // temporary settings that reflect the UI, only to instantly update the colours displayed in the UI
+    // loaded here rather than on the GUI thread, as reading the configuration is a large part of the cost
+    InternalSettingsPtr temporaryColorSettings = InternalSettingsPtr(new InternalSettings);
     temporaryColorSettings->load();
 
-    // temporaryColorSettings->setButtonIconColors(m_ui->buttonIconColors->currentIndex());
-    temporaryColorSettings->setCloseButtonIconColor(active, convertCloseButtonIconColorUiToSettingsIndex(active, uiCloseButtonIconColor->currentIndex()));
-    // temporaryColorSettings->setButtonBackgroundColors(m_ui->buttonBackgroundColors->currentIndex());
-    temporaryColorSettings->setNegativeCloseBackgroundHoverPress(active, uiNegativeCloseBackgroundHoverPress->isChecked());
-    // temporaryColorSettings->setLockButtonColorsActive(m_ui->lockButtonColorsActive->isChecked());
-    temporaryColorSettings->setOnPoorIconContrast(active, uiSetOnPoorIconContrast->currentIndex());
-    temporaryColorSettings->setAdjustBackgroundColorOnPoorContrast(active, uiSetAdjustBackgroundColorOnPoorContrast->isChecked());
-    temporaryColorSettings->setButtonIconOpacity(active, uiSetButtonIconOpacity->value());
-    temporaryColorSettings->setButtonBackgroundOpacity(active, uiSetButtonBackgroundOpacity->value());
-    temporaryColorSettings->setUseHoverAccent(active, uiUseHoverAccentActive->isChecked());
+    temporaryColorSettings->setCloseButtonIconColor(active, state.closeButtonIconColor);
+    temporaryColorSettings->setNegativeCloseBackgroundHoverPress(active, state.negativeCloseBackgroundHoverPress);
+    temporaryColorSettings->setOnPoorIconContrast(active, state.onPoorIconContrast);
+    temporaryColorSettings->setAdjustBackgroundColorOnPoorContrast(active, state.adjustBackgroundColorOnPoorContrast);
+    temporaryColorSettings->setButtonIconOpacity(active, state.buttonIconOpacity);
+    temporaryColorSettings->setButtonBackgroundOpacity(active, state.buttonBackgroundOpacity);
+    temporaryColorSettings->setUseHoverAccent(active, state.useHoverAccent);
 
     DecorationColors decorationPalette(false);
-    decorationPalette.generateDecorationColors(QApplication::palette(),
+    decorationPalette.generateDecorationColors(state.palette,
                                                temporaryColorSettings,
-                                               m_systemTitleBarTextActive,
-                                               m_systemTitlebarBackgroundActive,
-                                               m_systemTitleBarTextInactive,
-                                               m_systemTitlebarBackgroundInactive,
+                                               state.systemTitleBarTextActive,
+                                               state.systemTitlebarBackgroundActive,
+                                               state.systemTitleBarTextInactive,
+                                               state.systemTitlebarBackgroundInactive,
                                                "",
                                                true,
                                                active);
@@ -1595,11 +1674,11 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
     DecorationButtonPalette otherButtonPalette(DecorationButtonType::Custom);
 
     QList<DecorationButtonPalette *> otherCloseButtonList{&otherButtonPalette, &closeButtonPalette};
-    otherCloseButtonList = sortButtonsAsPerKwinConfig(otherCloseButtonList);
+    otherCloseButtonList = sortButtonsAsPerKwinConfig(otherCloseButtonList, state.visibleButtonsOrder);
     QList<DecorationButtonPalette *> otherTrafficLightsButtonList{&otherButtonPalette, &closeButtonPalette, &maximizeButtonPalette, &minimizeButtonPalette};
-    otherTrafficLightsButtonList = sortButtonsAsPerKwinConfig(otherTrafficLightsButtonList);
+    otherTrafficLightsButtonList = sortButtonsAsPerKwinConfig(otherTrafficLightsButtonList, state.visibleButtonsOrder);
     QList<DecorationButtonPalette *> trafficLightsButtonList{&closeButtonPalette, &maximizeButtonPalette, &minimizeButtonPalette};
-    trafficLightsButtonList = sortButtonsAsPerKwinConfig(trafficLightsButtonList);
+    trafficLightsButtonList = sortButtonsAsPerKwinConfig(trafficLightsButtonList, state.visibleButtonsOrder);
 
     qreal size = 32;
 
@@ -1640,8 +1719,8 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
     fourByThree[3][1] = QRectF(QPointF(size * 3 / 4, size / 3), QPointF(size, size * 2 / 3));
     fourByThree[3][2] = QRectF(QPointF(size * 3 / 4, size * 2 / 3), QPointF(size, size));
 
-    QPixmap pixmap(size, size);
-    std::unique_ptr<QPainter> painter = std::make_unique<QPainter>(&pixmap);
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    std::unique_ptr<QPainter> painter = std::make_unique<QPainter>(&image);
     painter->setPen(Qt::NoPen);
 
     // background colors
@@ -1650,8 +1729,7 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    uiButtonBackgroundColors->setIconSize(QSize(size, size));
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->backgroundNormal.isValid()
@@ -1667,15 +1745,17 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon titlebarText(pixmap);
-    uiButtonBackgroundColors->setItemIcon(InternalSettings::EnumButtonBackgroundColors::TitleBarText, titlebarText);
+    previews.append({ButtonBackgroundColorsPreview, InternalSettings::EnumButtonBackgroundColors::TitleBarText, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonBackgroundColors(active, InternalSettings::EnumButtonBackgroundColors::TitleBarTextNegativeClose);
     for (auto &buttonPalette : otherCloseButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->backgroundNormal.isValid()
@@ -1691,15 +1771,17 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon backgroundTitleBarTextNegativeClose(pixmap);
-    uiButtonBackgroundColors->setItemIcon(InternalSettings::EnumButtonBackgroundColors::TitleBarTextNegativeClose, backgroundTitleBarTextNegativeClose);
+    previews.append({ButtonBackgroundColorsPreview, InternalSettings::EnumButtonBackgroundColors::TitleBarTextNegativeClose, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonBackgroundColors(active, InternalSettings::EnumButtonBackgroundColors::Accent);
     for (auto &buttonPalette : otherCloseButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->backgroundNormal.isValid()
@@ -1715,15 +1797,17 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon backgroundAccent(pixmap);
-    uiButtonBackgroundColors->setItemIcon(InternalSettings::EnumButtonBackgroundColors::Accent, backgroundAccent);
+    previews.append({ButtonBackgroundColorsPreview, InternalSettings::EnumButtonBackgroundColors::Accent, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonBackgroundColors(active, InternalSettings::EnumButtonBackgroundColors::AccentNegativeClose);
     for (auto &buttonPalette : otherCloseButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->backgroundNormal.isValid()
@@ -1739,8 +1823,10 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon backgroundAccentNegativeClose(pixmap);
-    uiButtonBackgroundColors->setItemIcon(InternalSettings::EnumButtonBackgroundColors::AccentNegativeClose, backgroundAccentNegativeClose);
+    previews.append({ButtonBackgroundColorsPreview, InternalSettings::EnumButtonBackgroundColors::AccentNegativeClose, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonBackgroundColors(active, InternalSettings::EnumButtonBackgroundColors::AccentTrafficLights);
 
@@ -1748,7 +1834,7 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     }
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 4; i++) {
         if (i < otherTrafficLightsButtonList.count()) {
             painter->setBrush(getGroup(otherTrafficLightsButtonList[i], active)->backgroundNormal.isValid()
@@ -1765,19 +1851,20 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(fourByThree[i][2]);
         }
     }
-    QIcon backgroundAccentTrafficLightsClose(pixmap);
-    uiButtonBackgroundColors->setItemIcon(InternalSettings::EnumButtonBackgroundColors::AccentTrafficLights, backgroundAccentTrafficLightsClose);
+    previews.append({ButtonBackgroundColorsPreview, InternalSettings::EnumButtonBackgroundColors::AccentTrafficLights, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     // icon colors ---------------------------------------------------------------------------------
-    uiButtonIconColors->setIconSize(QSize(24, 24));
-    temporaryColorSettings->setButtonBackgroundColors(active, uiButtonBackgroundColors->currentIndex());
+    temporaryColorSettings->setButtonBackgroundColors(active, state.buttonBackgroundColors);
 
     temporaryColorSettings->setButtonIconColors(active, InternalSettings::EnumButtonIconColors::TitleBarText);
     for (auto &buttonPalette : otherCloseButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->foregroundNormal.isValid()
@@ -1792,15 +1879,17 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon iconTitleBarText(pixmap);
-    uiButtonIconColors->setItemIcon(InternalSettings::EnumButtonIconColors::TitleBarText, iconTitleBarText);
+    previews.append({ButtonIconColorsPreview, InternalSettings::EnumButtonIconColors::TitleBarText, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonIconColors(active, InternalSettings::EnumButtonIconColors::TitleBarTextNegativeClose);
     for (auto &buttonPalette : otherCloseButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->foregroundNormal.isValid()
@@ -1815,15 +1904,17 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon iconTitleBarTextNegativeClose(pixmap);
-    uiButtonIconColors->setItemIcon(InternalSettings::EnumButtonIconColors::TitleBarTextNegativeClose, iconTitleBarTextNegativeClose);
+    previews.append({ButtonIconColorsPreview, InternalSettings::EnumButtonIconColors::TitleBarTextNegativeClose, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonIconColors(active, InternalSettings::EnumButtonIconColors::Accent);
     for (auto &buttonPalette : otherCloseButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->foregroundNormal.isValid()
@@ -1838,15 +1929,17 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon iconAccent(pixmap);
-    uiButtonIconColors->setItemIcon(InternalSettings::EnumButtonIconColors::Accent, iconAccent);
+    previews.append({ButtonIconColorsPreview, InternalSettings::EnumButtonIconColors::Accent, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonIconColors(active, InternalSettings::EnumButtonIconColors::AccentNegativeClose);
     for (auto &buttonPalette : otherCloseButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     };
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 2; i++) {
         if (i < otherCloseButtonList.count()) {
             painter->setBrush(getGroup(otherCloseButtonList[i], active)->foregroundNormal.isValid()
@@ -1861,15 +1954,17 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(twoByThree[i][2]);
         }
     }
-    QIcon iconAccentNegativeClose(pixmap);
-    uiButtonIconColors->setItemIcon(InternalSettings::EnumButtonIconColors::AccentNegativeClose, iconAccentNegativeClose);
+    previews.append({ButtonIconColorsPreview, InternalSettings::EnumButtonIconColors::AccentNegativeClose, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     temporaryColorSettings->setButtonIconColors(active, InternalSettings::EnumButtonIconColors::AccentTrafficLights);
     for (auto &buttonPalette : otherTrafficLightsButtonList) {
         buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
     }
 
-    pixmap.fill(Qt::transparent);
+    image.fill(Qt::transparent);
     for (int i = 0; i < 4; i++) {
         if (i < otherTrafficLightsButtonList.count()) {
             painter->setBrush(getGroup(otherTrafficLightsButtonList[i], active)->foregroundNormal.isValid()
@@ -1886,22 +1981,23 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             painter->drawRect(fourByThree[i][2]);
         }
     }
-    QIcon iconAccentTrafficLights(pixmap);
-    uiButtonIconColors->setItemIcon(InternalSettings::EnumButtonIconColors::AccentTrafficLights, iconAccentTrafficLights);
+    previews.append({ButtonIconColorsPreview, InternalSettings::EnumButtonIconColors::AccentTrafficLights, image.copy()});
+    if (cancelled) {
+        return {};
+    }
 
     // closeButtonIconColor icons ----------------------------------------------------
 
-    uiCloseButtonIconColor->setIconSize(QSize(16, 16));
-    temporaryColorSettings->setButtonIconColors(active, uiButtonIconColors->currentIndex());
+    temporaryColorSettings->setButtonIconColors(active, state.buttonIconColors);
 
-    int uiItemIndex = convertCloseButtonIconColorSettingsToUiIndex(active, InternalSettings::EnumCloseButtonIconColor::AsSelected);
+    int uiItemIndex = state.closeButtonIconColorUiIndexes.value(InternalSettings::EnumCloseButtonIconColor::AsSelected, -1);
     if (uiItemIndex >= 0) {
         temporaryColorSettings->setCloseButtonIconColor(active, InternalSettings::EnumCloseButtonIconColor::AsSelected);
-        if (uiButtonIconColors->currentIndex() == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
+        if (state.buttonIconColors == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
             for (auto &buttonPalette : trafficLightsButtonList) {
                 buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
             }
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             for (int i = 0; i < 3; i++) {
                 if (i < trafficLightsButtonList.count()) {
                     painter->setBrush(getGroup(trafficLightsButtonList[i], active)->foregroundNormal.isValid()
@@ -1920,7 +2016,7 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             }
         } else {
             closeButtonPalette.generate(temporaryColorSettings, &decorationPalette, true, active);
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             painter->setBrush(getGroup(&closeButtonPalette, active)->foregroundNormal.isValid() ? getGroup(&closeButtonPalette, active)->foregroundNormal
                                                                                                 : Qt::transparent);
             painter->drawRect(oneByThree00);
@@ -1931,18 +2027,20 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
                                                                                                : Qt::transparent);
             painter->drawRect(oneByThree02);
         }
-        QIcon icon(pixmap);
-        uiCloseButtonIconColor->setItemIcon(uiItemIndex, icon);
+        previews.append({CloseButtonIconColorPreview, uiItemIndex, image.copy()});
+        if (cancelled) {
+            return {};
+        }
     }
 
-    uiItemIndex = convertCloseButtonIconColorSettingsToUiIndex(active, InternalSettings::EnumCloseButtonIconColor::NegativeWhenHoverPress);
+    uiItemIndex = state.closeButtonIconColorUiIndexes.value(InternalSettings::EnumCloseButtonIconColor::NegativeWhenHoverPress, -1);
     if (uiItemIndex >= 0) {
         temporaryColorSettings->setCloseButtonIconColor(active, InternalSettings::EnumCloseButtonIconColor::NegativeWhenHoverPress);
-        if (uiButtonIconColors->currentIndex() == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
+        if (state.buttonIconColors == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
             for (auto &buttonPalette : trafficLightsButtonList) {
                 buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
             }
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             for (int i = 0; i < 3; i++) {
                 if (i < trafficLightsButtonList.count()) {
                     painter->setBrush(getGroup(trafficLightsButtonList[i], active)->foregroundNormal.isValid()
@@ -1961,7 +2059,7 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             }
         } else {
             closeButtonPalette.generate(temporaryColorSettings, &decorationPalette, true, active);
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             painter->setBrush(getGroup(&closeButtonPalette, active)->foregroundNormal.isValid() ? getGroup(&closeButtonPalette, active)->foregroundNormal
                                                                                                 : Qt::transparent);
             painter->drawRect(oneByThree00);
@@ -1972,18 +2070,20 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
                                                                                                : Qt::transparent);
             painter->drawRect(oneByThree02);
         }
-        QIcon icon(pixmap);
-        uiCloseButtonIconColor->setItemIcon(uiItemIndex, icon);
+        previews.append({CloseButtonIconColorPreview, uiItemIndex, image.copy()});
+        if (cancelled) {
+            return {};
+        }
     }
 
-    uiItemIndex = convertCloseButtonIconColorSettingsToUiIndex(active, InternalSettings::EnumCloseButtonIconColor::White);
+    uiItemIndex = state.closeButtonIconColorUiIndexes.value(InternalSettings::EnumCloseButtonIconColor::White, -1);
     if (uiItemIndex >= 0) {
         temporaryColorSettings->setCloseButtonIconColor(active, InternalSettings::EnumCloseButtonIconColor::White);
-        if (uiButtonIconColors->currentIndex() == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
+        if (state.buttonIconColors == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
             for (auto &buttonPalette : trafficLightsButtonList) {
                 buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
             }
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             for (int i = 0; i < 3; i++) {
                 if (i < trafficLightsButtonList.count()) {
                     painter->setBrush(getGroup(trafficLightsButtonList[i], active)->foregroundNormal.isValid()
@@ -2002,7 +2102,7 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             }
         } else {
             closeButtonPalette.generate(temporaryColorSettings, &decorationPalette, true, active);
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             painter->setBrush(getGroup(&closeButtonPalette, active)->foregroundNormal.isValid() ? getGroup(&closeButtonPalette, active)->foregroundNormal
                                                                                                 : Qt::transparent);
             painter->drawRect(oneByThree00);
@@ -2013,19 +2113,21 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
                                                                                                : Qt::transparent);
             painter->drawRect(oneByThree02);
         }
-        QIcon icon(pixmap);
-        uiCloseButtonIconColor->setItemIcon(uiItemIndex, icon);
+        previews.append({CloseButtonIconColorPreview, uiItemIndex, image.copy()});
+        if (cancelled) {
+            return {};
+        }
     }
 
-    uiItemIndex = convertCloseButtonIconColorSettingsToUiIndex(active, InternalSettings::EnumCloseButtonIconColor::WhiteWhenHoverPress);
+    uiItemIndex = state.closeButtonIconColorUiIndexes.value(InternalSettings::EnumCloseButtonIconColor::WhiteWhenHoverPress, -1);
     if (uiItemIndex >= 0) {
         temporaryColorSettings->setCloseButtonIconColor(active, InternalSettings::EnumCloseButtonIconColor::WhiteWhenHoverPress);
 
-        if (uiButtonIconColors->currentIndex() == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
+        if (state.buttonIconColors == InternalSettings::EnumButtonIconColors::AccentTrafficLights) {
             for (auto &buttonPalette : trafficLightsButtonList) {
                 buttonPalette->generate(temporaryColorSettings, &decorationPalette, true, active);
             }
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             for (int i = 0; i < 3; i++) {
                 if (i < trafficLightsButtonList.count()) {
                     painter->setBrush(getGroup(trafficLightsButtonList[i], active)->foregroundNormal.isValid()
@@ -2044,7 +2146,7 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
             }
         } else {
             closeButtonPalette.generate(temporaryColorSettings, &decorationPalette, true, active);
-            pixmap.fill(Qt::transparent);
+            image.fill(Qt::transparent);
             painter->setBrush(getGroup(&closeButtonPalette, active)->foregroundNormal.isValid() ? getGroup(&closeButtonPalette, active)->foregroundNormal
                                                                                                 : Qt::transparent);
             painter->drawRect(oneByThree00);
@@ -2055,9 +2157,14 @@ void ButtonColors::loadButtonPaletteColorsIconsMain(bool active)
                                                                                                : Qt::transparent);
             painter->drawRect(oneByThree02);
         }
-        QIcon icon(pixmap);
-        uiCloseButtonIconColor->setItemIcon(uiItemIndex, icon);
+        previews.append({CloseButtonIconColorPreview, uiItemIndex, image.copy()});
+        if (cancelled) {
+            return {};
+        }
     }
+
+    painter.reset();
+    return previews;
 }
 
 void ButtonColors::getButtonsOrderFromKwinConfig()
@@ -2178,13 +2285,14 @@ void ButtonColors::getButtonsOrderFromKwinConfig()
                                  DecorationButtonType::Custom); // dummy Custom button inserted for illustrating colour palettes in icons
 }
 
-QList<DecorationButtonPalette *> ButtonColors::sortButtonsAsPerKwinConfig(QList<DecorationButtonPalette *> inputlist)
+QList<DecorationButtonPalette *> ButtonColors::sortButtonsAsPerKwinConfig(QList<DecorationButtonPalette *> inputlist,
+                                                                         const QList<DecorationButtonType> &visibleButtonsOrder)
 {
     QList<DecorationButtonPalette *> outputlist;
 
-    for (int i = 0; i < m_visibleButtonsOrder.count(); i++) {
+    for (int i = 0; i < visibleButtonsOrder.count(); i++) {
         for (int j = inputlist.count() - 1; j >= 0; j--) { // iterate loop in reverse order as want to delete elements
-            if (m_visibleButtonsOrder[i] == (inputlist[j])->buttonType()) {
+            if (visibleButtonsOrder[i] == (inputlist[j])->buttonType()) {
                 outputlist.append(inputlist[j]);
                 inputlist.removeAt(j);
             }
@@ -10,6 +10,7 @@
 #include "breezesettings.h"
 #include "colortools.h"
 #include "decorationcolors.h"
+#include "previewrenderer.h"
 #include "ui_buttoncolors.h"
 #include <KColorButton>
 #include <QDialog>
@@ -107,7 +108,8 @@ Q_SIGNALS:
 
 private:
     void getButtonsOrderFromKwinConfig();
-    QList<Breeze::DecorationButtonPalette *> sortButtonsAsPerKwinConfig(QList<Breeze::DecorationButtonPalette *> inputlist);
+    static QList<Breeze::DecorationButtonPalette *> sortButtonsAsPerKwinConfig(QList<Breeze::DecorationButtonPalette *> inputlist,
+                                                                               const QList<DecorationButtonType> &visibleButtonsOrder);
 
     void generateTableCells(QTableWidget *table);
 
@@ -146,13 +148,52 @@ private:
 
     void setHorizontalHeaderSectionIcon(DecorationButtonType type, QTableWidget *table, int section);
 
+    //* snapshot of the UI state that the button palette preview icons depend upon
+    struct ButtonPalettePreviewState {
+        bool active = true;
+        QPalette palette;
+        QColor systemTitleBarTextActive;
+        QColor systemTitlebarBackgroundActive;
+        QColor systemTitleBarTextInactive;
+        QColor systemTitlebarBackgroundInactive;
+        int closeButtonIconColor = 0;
+        bool negativeCloseBackgroundHoverPress = false;
+        int onPoorIconContrast = 0;
+        bool adjustBackgroundColorOnPoorContrast = false;
+        int buttonIconOpacity = 100;
+        int buttonBackgroundOpacity = 100;
+        bool useHoverAccent = false;
+        int buttonBackgroundColors = 0;
+        int buttonIconColors = 0;
+        QMap<int, int> closeButtonIconColorUiIndexes; // settings index to UI index
+        QList<DecorationButtonType> visibleButtonsOrder;
+        qint64 configFileModified = 0;
+        qint64 configFileSize = 0;
+
+        //* preview cache key
+        QByteArray key() const;
+    };
+
+    //* PreviewImage targets for the button palette previews
+    enum ButtonPalettePreviewTarget {
+        ButtonBackgroundColorsPreview,
+        ButtonIconColorsPreview,
+        CloseButtonIconColorPreview,
+    };
+
+    //* requests the preview icons for the palette combo boxes, which are rendered asynchronously
     void loadButtonPaletteColorsIconsMain(bool active);
 
+    //* renders the palette combo box preview icons; runs on a worker thread
+    static PreviewImages renderButtonPalettePreviews(const ButtonPalettePreviewState &state, const std::atomic<bool> &cancelled);
+
     void setChanged(bool value);
     bool isDefaults();
 
     Ui_ButtonColors *m_ui;
 
+    PreviewRenderer *m_palettePreviewRenderer;
+
     InternalSettingsPtr m_internalSettings;
     KSharedConfig::Ptr m_configuration;
     KSharedConfig::Ptr m_presetsConfiguration;
@@ -8,6 +8,7 @@
 #include "breezeconfigwidget.h"
 #include "dbusmessages.h"
 #include "presetsmodel.h"
+#include "settingssnapshot.h"
 
 namespace Breeze
 {
@@ -323,6 +324,7 @@ void ButtonSizing::save(const bool reloadKwinConfig)
     setChanged(false);
 
     if (reloadKwinConfig) {
+        SettingsSnapshot::write();
         DBusMessages::kwinReloadConfig();
 
         static_cast<ConfigWidget *>(m_parent)->generateSystemIcons();
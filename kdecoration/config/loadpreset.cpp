@@ -9,6 +9,7 @@
 #include "breezeconfigwidget.h"
 #include "dbusmessages.h"
 #include "presetsmodel.h"
+#include "settingssnapshot.h"
 #include <QDir>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -115,6 +116,7 @@ void LoadPreset::loadButtonClicked()
 
         ConfigWidget *configWidget = static_cast<ConfigWidget *>(m_parent);
         configWidget->load();
+        SettingsSnapshot::write();
         DBusMessages::updateDecorationColorCache();
         DBusMessages::kwinReloadConfig();
         configWidget->generateSystemIcons();
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "previewrenderer.h"
+
+#include <utility>
+
+namespace Breeze
+{
+
+PreviewRenderer::PreviewRenderer(QObject *parent)
+    : QObject(parent)
+    , m_cache(s_cacheSize)
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(s_debounceInterval);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &PreviewRenderer::startPendingRender);
+
+    // a second thread lets a new render start while a cancelled one is winding down
+    m_threadPool.setMaxThreadCount(2);
+}
+
+PreviewRenderer::~PreviewRenderer()
+{
+    if (m_runningCancelled) {
+        m_runningCancelled->store(true);
+    }
+    m_threadPool.waitForDone();
+}
+
+void PreviewRenderer::request(const QByteArray &key, RenderFunction render, ApplyFunction apply)
+{
+    m_generation++;
+    if (m_runningCancelled) {
+        m_runningCancelled->store(true);
+        m_runningCancelled.reset();
+    }
+
+    if (const PreviewImages *cached = m_cache.object(key)) {
+        m_debounceTimer.stop();
+        m_pendingRender = nullptr;
+        m_pendingApply = nullptr;
+        apply(*cached);
+        return;
+    }
+
+    m_pendingKey = key;
+    m_pendingRender = std::move(render);
+    m_pendingApply = std::move(apply);
+    m_debounceTimer.start();
+}
+
+void PreviewRenderer::clearCache()
+{
+    m_cache.clear();
+}
+
+void PreviewRenderer::startPendingRender()
+{
+    if (!m_pendingRender) {
+        return;
+    }
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_runningCancelled = cancelled;
+
+    const quint64 generation = m_generation;
+    const QByteArray key = std::exchange(m_pendingKey, QByteArray());
+    RenderFunction render = std::exchange(m_pendingRender, nullptr);
+    ApplyFunction apply = std::exchange(m_pendingApply, nullptr);
+
+    // the destructor waits for the thread pool, so this outlives the render
+    m_threadPool.start([this, generation, key, render, apply, cancelled]() {
+        const PreviewImages images = render(*cancelled);
+        if (cancelled->load()) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, key, images, apply]() {
+                renderFinished(generation, key, images, apply);
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void PreviewRenderer::renderFinished(quint64 generation, const QByteArray &key, const PreviewImages &images, const ApplyFunction &apply)
+{
+    m_cache.insert(key, new PreviewImages(images), qMax(1, int(images.count())));
+
+    if (generation == m_generation) {
+        m_runningCancelled.reset();
+        apply(images);
+    }
+}
+
+}
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace Breeze
+{
+
+//* a rendered preview, and where in the UI it is to be shown
+struct PreviewImage {
+    int target; // caller-defined, e.g. which combo box
+    int index; // e.g. the combo box item
+    QImage image;
+};
+
+using PreviewImages = QList<PreviewImage>;
+
+/**
+ * @brief Renders configuration UI preview images on a worker thread.
+ *        Requests are debounced, so that e.g. dragging a slider only renders once the value settles, and a newer request cancels any render in progress.
+ *        Results are cached by a key describing the UI state, so returning to an earlier state applies its previews immediately.
+ */
+class PreviewRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    //* runs on the worker thread, so must only use the state it has captured and not touch any widgets; should return early once cancelled is set
+    using RenderFunction = std::function<PreviewImages(const std::atomic<bool> &cancelled)>;
+
+    //* runs on the GUI thread with the rendered previews
+    using ApplyFunction = std::function<void(const PreviewImages &)>;
+
+    explicit PreviewRenderer(QObject *parent = nullptr);
+
+    //* waits for any running render, as it may use code from this plugin
+    ~PreviewRenderer() override;
+
+    /**
+     * @brief Request previews for the given UI state
+     * @param key Uniquely identifies everything the render function depends upon
+     * @param render Renders the previews
+     * @param apply Shows the previews in the UI; not called if a newer request is made before the render finishes
+     */
+    void request(const QByteArray &key, RenderFunction render, ApplyFunction apply);
+
+    //* drop the cached previews, e.g. when the saved settings or system palette the renders depend upon have changed
+    void clearCache();
+
+private Q_SLOTS:
+    void startPendingRender();
+
+private:
+    void renderFinished(quint64 generation, const QByteArray &key, const PreviewImages &images, const ApplyFunction &apply);
+
+    //* time for the UI state to settle before rendering
+    static constexpr int s_debounceInterval = 40;
+
+    //* maximum number of cached preview images
+    static constexpr int s_cacheSize = 512;
+
+    QTimer m_debounceTimer;
+    QThreadPool m_threadPool;
+    QCache<QByteArray, PreviewImages> m_cache;
+
+    //* incremented on every request; renders from an earlier generation are stale
+    quint64 m_generation = 0;
+    std::shared_ptr<std::atomic<bool>> m_runningCancelled;
+
+    QByteArray m_pendingKey;
+    RenderFunction m_pendingRender;
+    ApplyFunction m_pendingApply;
+};
+
+}
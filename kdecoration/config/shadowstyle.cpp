@@ -8,6 +8,7 @@
 #include "breezeconfigwidget.h"
 #include "dbusmessages.h"
 #include "presetsmodel.h"
+#include "settingssnapshot.h"
 #include <QPushButton>
 
 namespace Breeze
@@ -79,6 +80,7 @@ void ShadowStyle::save(const bool reloadKwinConfig)
     setChanged(false);
 
     if (reloadKwinConfig) {
+        SettingsSnapshot::write();
         DBusMessages::updateDecorationColorCache();
         DBusMessages::kwinReloadConfig();
         // DBusMessages::kstyleReloadDecorationConfig(); //should reload anyway
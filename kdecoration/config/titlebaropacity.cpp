@@ -9,6 +9,7 @@
 #include "dbusmessages.h"
 #include "decorationcolors.h"
 #include "presetsmodel.h"
+#include "settingssnapshot.h"
 #include <KColorScheme>
 #include <QPushButton>
 
@@ -126,6 +127,7 @@ void TitleBarOpacity::save(const bool reloadKwinConfig)
     setChanged(false);
 
     if (reloadKwinConfig) {
+        SettingsSnapshot::write();
         DBusMessages::updateDecorationColorCache();
         DBusMessages::kwinReloadConfig();
         // DBusMessages::kstyleReloadDecorationConfig(); //should reload anyway
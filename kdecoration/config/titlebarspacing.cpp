@@ -8,6 +8,7 @@
 #include "breezeconfigwidget.h"
 #include "dbusmessages.h"
 #include "presetsmodel.h"
+#include "settingssnapshot.h"
 #include <QPushButton>
 
 namespace Breeze
@@ -96,8 +97,10 @@ void TitleBarSpacing::save(const bool reloadKwinConfig)
     m_internalSettings->save();
     setChanged(false);
 
-    if (reloadKwinConfig)
+    if (reloadKwinConfig) {
+        SettingsSnapshot::write();
         DBusMessages::kwinReloadConfig();
+    }
 }
 
 void TitleBarSpacing::defaults()
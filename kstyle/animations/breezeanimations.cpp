@@ -7,6 +7,7 @@
 #include "breezeanimations.h"
 #include "breezepropertynames.h"
 #include "breezestyleconfigdata.h"
+#include "breezewidgetclassification.h"
 
 #include <QAbstractItemView>
 #include <QCheckBox>
@@ -100,16 +101,17 @@ void Animations::registerWidget(QWidget *widget) const
 
     // install animation timers
     // for optimization, one should put with most used widgets here first
+    const WidgetClassification::Roles roles = WidgetClassification::roles(widget);
 
     // buttons
-    if (qobject_cast<QToolButton *>(widget)) {
+    if (roles & WidgetClassification::ToolButton) {
         _toolButtonEngine->registerWidget(widget, AnimationHover | AnimationFocus);
         _widgetStateEngine->registerWidget(widget, AnimationHover | AnimationFocus);
 
-    } else if (qobject_cast<QCheckBox *>(widget) || qobject_cast<QRadioButton *>(widget)) {
+    } else if (roles & (WidgetClassification::CheckBox | WidgetClassification::RadioButton)) {
         _widgetStateEngine->registerWidget(widget, AnimationHover | AnimationFocus | AnimationPressed);
 
-    } else if (qobject_cast<QAbstractButton *>(widget)) {
+    } else if (roles & WidgetClassification::AbstractButton) {
         // register to toolbox engine if needed
         if (qobject_cast<QToolBox *>(widget->parent())) {
             _toolBoxEngine->registerWidget(widget);
@@ -120,73 +122,73 @@ void Animations::registerWidget(QWidget *widget) const
     }
 
     // groupboxes
-    else if (QGroupBox *groupBox = qobject_cast<QGroupBox *>(widget)) {
-        if (groupBox->isCheckable()) {
+    else if (roles & WidgetClassification::GroupBox) {
+        if (static_cast<QGroupBox *>(widget)->isCheckable()) {
             _widgetStateEngine->registerWidget(widget, AnimationHover | AnimationFocus);
         }
     }
 
     // sliders
-    else if (qobject_cast<QScrollBar *>(widget)) {
+    else if (roles & WidgetClassification::ScrollBar) {
         _scrollBarEngine->registerWidget(widget, AnimationHover | AnimationFocus);
-    } else if (qobject_cast<QSlider *>(widget)) {
+    } else if (roles & WidgetClassification::Slider) {
         _widgetStateEngine->registerWidget(widget, AnimationHover | AnimationFocus);
-    } else if (qobject_cast<QDial *>(widget)) {
+    } else if (roles & WidgetClassification::Dial) {
         _dialEngine->registerWidget(widget, AnimationHover | AnimationFocus);
     }
 
     // progress bar
-    else if (qobject_cast<QProgressBar *>(widget)) {
+    else if (roles & WidgetClassification::ProgressBar) {
         _busyIndicatorEngine->registerWidget(widget);
     }
 
     // combo box
-    else if (qobject_cast<QComboBox *>(widget)) {
+    else if (roles & WidgetClassification::ComboBox) {
         _comboBoxEngine->registerWidget(widget, AnimationHover);
         _inputWidgetEngine->registerWidget(widget, AnimationHover | AnimationFocus);
     }
 
     // spinbox
-    else if (qobject_cast<QSpinBox *>(widget)) {
+    else if (roles & WidgetClassification::SpinBox) {
         _spinBoxEngine->registerWidget(widget);
         _inputWidgetEngine->registerWidget(widget, AnimationHover | AnimationFocus);
     }
 
     // editors
-    else if (qobject_cast<QLineEdit *>(widget)) {
+    else if (roles & WidgetClassification::LineEdit) {
         _inputWidgetEngine->registerWidget(widget, AnimationHover | AnimationFocus);
-    } else if (qobject_cast<QTextEdit *>(widget)) {
+    } else if (roles & WidgetClassification::TextEdit) {
         _inputWidgetEngine->registerWidget(widget, AnimationHover | AnimationFocus);
-    } else if (widget->inherits("KTextEditor::View")) {
+    } else if (roles & WidgetClassification::KTextEditorView) {
         _inputWidgetEngine->registerWidget(widget, AnimationHover | AnimationFocus);
     }
 
     // header views
     // need to come before abstract item view, otherwise is skipped
-    else if (qobject_cast<QHeaderView *>(widget)) {
+    else if (roles & WidgetClassification::HeaderView) {
         _headerViewEngine->registerWidget(widget);
     }
 
     // lists
-    else if (qobject_cast<QAbstractItemView *>(widget)) {
+    else if (roles & WidgetClassification::AbstractItemView) {
         _inputWidgetEngine->registerWidget(widget, AnimationHover | AnimationFocus);
     }
 
     // tabbar
-    else if (qobject_cast<QTabBar *>(widget)) {
+    else if (roles & WidgetClassification::TabBar) {
         _tabBarEngine->registerWidget(widget);
     }
 
     // scrollarea
-    else if (QAbstractScrollArea *scrollArea = qobject_cast<QAbstractScrollArea *>(widget)) {
-        if (scrollArea->frameShadow() == QFrame::Sunken && (widget->focusPolicy() & Qt::StrongFocus)) {
+    else if (roles & WidgetClassification::AbstractScrollArea) {
+        if (static_cast<QAbstractScrollArea *>(widget)->frameShadow() == QFrame::Sunken && (widget->focusPolicy() & Qt::StrongFocus)) {
             _inputWidgetEngine->registerWidget(widget, AnimationHover | AnimationFocus);
         }
     }
 
     // stacked widgets
-    if (QStackedWidget *stack = qobject_cast<QStackedWidget *>(widget)) {
-        _stackedWidgetEngine->registerWidget(stack);
+    if (roles & WidgetClassification::StackedWidget) {
+        _stackedWidgetEngine->registerWidget(static_cast<QStackedWidget *>(widget));
     }
 }
 
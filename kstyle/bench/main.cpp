@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "benchmarktools.h"
+#include "stylebenchmark.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QPluginLoader>
+#include <QStylePlugin>
+#include <QTemporaryDir>
+
+#include <iostream>
+
+using namespace Breeze;
+
+int main(int argc, char *argv[])
+{
+    // run headless, and against a private configuration so that the results do not depend on the user's klassyrc
+    QTemporaryDir configDir;
+    if (!BenchmarkTools::setUpEnvironment(configDir, "klassy-style-bench")) {
+        return 1;
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("klassy-style-bench"));
+    app.setApplicationVersion(QStringLiteral(KLASSY_VERSION));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Renders a gallery of widgets with the Klassy style and outputs the timings as JSON"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption iterationsOption(QStringLiteral("iterations"), QStringLiteral("Number of timed renders at each scale."), QStringLiteral("n"), QStringLiteral("50"));
+    QCommandLineOption pluginOption(QStringLiteral("plugin"),
+                                    QStringLiteral("Path of the Klassy style plugin to load."),
+                                    QStringLiteral("file"),
+                                    QStringLiteral(KLASSY_BENCH_STYLE_PLUGIN));
+    QCommandLineOption outputOption(QStringLiteral("output"), QStringLiteral("Write the JSON results to a file rather than stdout."), QStringLiteral("file"));
+    parser.addOptions({iterationsOption, pluginOption, outputOption});
+    parser.process(app);
+
+    // the cost the style adds to an application's startup: loading the plugin and its libraries (including their static initialisation), and creating
+    // the style, before the application's event loop runs
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+    QPluginLoader loader(parser.value(pluginOption));
+    auto stylePlugin = qobject_cast<QStylePlugin *>(loader.instance());
+    const qint64 pluginLoadNs = startupTimer.nsecsElapsed();
+    QStyle *klassyStyle = stylePlugin ? stylePlugin->create(QStringLiteral("klassy")) : nullptr;
+    const qint64 styleCreateNs = startupTimer.nsecsElapsed() - pluginLoadNs;
+    if (!klassyStyle) {
+        std::cerr << "klassy-style-bench: could not load the Klassy style from " << qPrintable(loader.fileName()) << ": " << qPrintable(loader.errorString())
+                  << std::endl;
+        return 1;
+    }
+
+    // the application takes ownership of the proxy, which takes ownership of the Klassy style
+    auto style = new TimingProxyStyle(klassyStyle);
+    QApplication::setStyle(style);
+
+    // work the style defers to the event loop still runs on the GUI thread before the application's first frame
+    startupTimer.restart();
+    QCoreApplication::processEvents();
+    const qint64 firstEventLoopNs = startupTimer.nsecsElapsed();
+
+    StyleBenchmark benchmark(style, parser.value(iterationsOption).toInt());
+
+    QJsonArray galleryResults;
+    for (const qreal devicePixelRatio : {1.0, 1.5, 2.0}) {
+        galleryResults.append(benchmark.runGallery(devicePixelRatio));
+    }
+
+    QJsonObject results;
+    results[QStringLiteral("benchmark")] = QStringLiteral("klassy-style-bench");
+    results[QStringLiteral("version")] = QStringLiteral(KLASSY_VERSION);
+    results[QStringLiteral("iterations")] = parser.value(iterationsOption).toInt();
+    results[QStringLiteral("startup")] = QJsonObject{{QStringLiteral("pluginLoadUs"), pluginLoadNs / 1000.0},
+                                                     {QStringLiteral("styleCreateUs"), styleCreateNs / 1000.0},
+                                                     {QStringLiteral("firstEventLoopUs"), firstEventLoopNs / 1000.0}};
+    results[QStringLiteral("gallery")] = galleryResults;
+    results[QStringLiteral("animations")] = benchmark.runAnimations();
+    results[QStringLiteral("widgetStateAccess")] = benchmark.runWidgetStateAccess();
+
+    return BenchmarkTools::writeResults(results, parser.value(outputOption));
+}
@@ -0,0 +1,444 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stylebenchmark.h"
+#include "benchmarktools.h"
+#include "breezewidgetstatetable.h"
+
+#include <QAbstractScrollArea>
+#include <QApplication>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDial>
+#include <QEnterEvent>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QImage>
+#include <QJsonArray>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QMdiArea>
+#include <QMdiSubWindow>
+#include <QMenu>
+#include <QMenuBar>
+#include <QMetaEnum>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QRadioButton>
+#include <QScrollArea>
+#include <QSlider>
+#include <QSpinBox>
+#include <QStackedWidget>
+#include <QTabBar>
+#include <QTabWidget>
+#include <QTextEdit>
+#include <QToolBar>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace Breeze
+{
+
+//________________________________________________________________
+TimingProxyStyle::TimingProxyStyle(QStyle *style)
+    : QProxyStyle(style)
+{
+}
+
+//________________________________________________________________
+void TimingProxyStyle::drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+
+    ElementTiming &timing = m_primitiveTimings[element];
+    timing.calls++;
+    timing.nsecs += timer.nsecsElapsed();
+}
+
+//________________________________________________________________
+void TimingProxyStyle::drawControl(ControlElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    QProxyStyle::drawControl(element, option, painter, widget);
+
+    ElementTiming &timing = m_controlTimings[element];
+    timing.calls++;
+    timing.nsecs += timer.nsecsElapsed();
+}
+
+//________________________________________________________________
+void TimingProxyStyle::drawComplexControl(ComplexControl control, const QStyleOptionComplex *option, QPainter *painter, const QWidget *widget) const
+{
+    QElapsedTimer timer;
+    timer.start();
+    QProxyStyle::drawComplexControl(control, option, painter, widget);
+
+    ElementTiming &timing = m_complexControlTimings[control];
+    timing.calls++;
+    timing.nsecs += timer.nsecsElapsed();
+}
+
+//________________________________________________________________
+QJsonObject TimingProxyStyle::elementTimings() const
+{
+    auto toJson = [](const QHash<int, ElementTiming> &timings, const QMetaEnum &metaEnum) {
+        QJsonObject result;
+        for (auto it = timings.cbegin(); it != timings.cend(); ++it) {
+            // custom KStyle elements have no name in the QStyle enums
+            const char *key = metaEnum.valueToKey(it.key());
+            const QString name = key ? QString::fromLatin1(key) : QString::number(it.key(), 16).prepend(QStringLiteral("0x"));
+
+            QJsonObject timing;
+            timing[QStringLiteral("calls")] = it->calls;
+            timing[QStringLiteral("totalUs")] = it->nsecs / 1000.0;
+            timing[QStringLiteral("meanUs")] = it->nsecs / 1000.0 / it->calls;
+            result[name] = timing;
+        }
+        return result;
+    };
+
+    QJsonObject result;
+    result[QStringLiteral("drawPrimitive")] = toJson(m_primitiveTimings, QMetaEnum::fromType<QStyle::PrimitiveElement>());
+    result[QStringLiteral("drawControl")] = toJson(m_controlTimings, QMetaEnum::fromType<QStyle::ControlElement>());
+    result[QStringLiteral("drawComplexControl")] = toJson(m_complexControlTimings, QMetaEnum::fromType<QStyle::ComplexControl>());
+    return result;
+}
+
+//________________________________________________________________
+void TimingProxyStyle::resetElementTimings()
+{
+    m_primitiveTimings.clear();
+    m_controlTimings.clear();
+    m_complexControlTimings.clear();
+}
+
+//________________________________________________________________
+StyleBenchmark::StyleBenchmark(TimingProxyStyle *style, int iterations)
+    : m_style(style)
+    , m_iterations(qMax(1, iterations))
+{
+    createGallery();
+}
+
+//________________________________________________________________
+StyleBenchmark::~StyleBenchmark()
+{
+    delete m_gallery;
+}
+
+//________________________________________________________________
+void StyleBenchmark::createGallery()
+{
+    m_gallery = new QWidget();
+    m_gallery->resize(1024, 900);
+    auto layout = new QGridLayout(m_gallery);
+
+    // buttons
+    auto buttonsBox = new QGroupBox(QStringLiteral("Buttons"));
+    auto buttonsLayout = new QVBoxLayout(buttonsBox);
+    auto pushButton = new QPushButton(QIcon::fromTheme(QStringLiteral("document-save")), QStringLiteral("Push button"));
+    m_hoverTarget = pushButton;
+    buttonsLayout->addWidget(pushButton);
+    auto defaultButton = new QPushButton(QStringLiteral("Default button"));
+    defaultButton->setDefault(true);
+    buttonsLayout->addWidget(defaultButton);
+    auto menuButton = new QPushButton(QStringLiteral("Menu button"));
+    menuButton->setMenu(new QMenu(menuButton));
+    buttonsLayout->addWidget(menuButton);
+    auto checkBox = new QCheckBox(QStringLiteral("Check box"));
+    checkBox->setChecked(true);
+    buttonsLayout->addWidget(checkBox);
+    auto tristateCheckBox = new QCheckBox(QStringLiteral("Tristate check box"));
+    tristateCheckBox->setTristate(true);
+    tristateCheckBox->setCheckState(Qt::PartiallyChecked);
+    buttonsLayout->addWidget(tristateCheckBox);
+    buttonsLayout->addWidget(new QRadioButton(QStringLiteral("Radio button")));
+    auto comboBox = new QComboBox();
+    comboBox->addItems({QStringLiteral("Combo box"), QStringLiteral("Second item")});
+    buttonsLayout->addWidget(comboBox);
+    buttonsLayout->addWidget(new QSpinBox());
+    buttonsLayout->addWidget(new QLineEdit(QStringLiteral("Line edit")));
+    layout->addWidget(buttonsBox, 0, 0);
+
+    // tab bar, containing a stacked widget whose page changes are animated
+    auto tabWidget = new QTabWidget();
+    tabWidget->setTabsClosable(true);
+    m_stackedWidget = new QStackedWidget();
+    m_stackedWidget->addWidget(new QLabel(QStringLiteral("First page")));
+    m_stackedWidget->addWidget(new QTextEdit(QStringLiteral("Second page")));
+    tabWidget->addTab(m_stackedWidget, QStringLiteral("Stacked pages"));
+    tabWidget->addTab(new QLabel(QStringLiteral("Second tab")), QStringLiteral("Second tab"));
+    tabWidget->addTab(new QLabel(QStringLiteral("Third tab")), QStringLiteral("Third tab"));
+    layout->addWidget(tabWidget, 0, 1);
+
+    // scroll area
+    auto scrollArea = new QScrollArea();
+    auto scrollContents = new QLabel(QStringLiteral("Scroll area contents"));
+    scrollContents->setMinimumSize(1200, 1200);
+    scrollArea->setWidget(scrollContents);
+    layout->addWidget(scrollArea, 1, 0);
+
+    // item views with check boxes
+    auto listWidget = new QListWidget();
+    auto treeWidget = new QTreeWidget();
+    treeWidget->setHeaderLabels({QStringLiteral("Name"), QStringLiteral("Value")});
+    for (int i = 0; i < 20; i++) {
+        auto listItem = new QListWidgetItem(QStringLiteral("List item %1").arg(i), listWidget);
+        listItem->setFlags(listItem->flags() | Qt::ItemIsUserCheckable);
+        listItem->setCheckState(i % 2 ? Qt::Checked : Qt::Unchecked);
+
+        auto treeItem = new QTreeWidgetItem(treeWidget, {QStringLiteral("Tree item %1").arg(i), QString::number(i)});
+        treeItem->setCheckState(0, i % 2 ? Qt::Checked : Qt::Unchecked);
+        new QTreeWidgetItem(treeItem, {QStringLiteral("Child"), QString()});
+    }
+    listWidget->setCurrentRow(1);
+    treeWidget->expandAll();
+    auto itemViews = new QWidget();
+    auto itemViewsLayout = new QVBoxLayout(itemViews);
+    itemViewsLayout->addWidget(listWidget);
+    itemViewsLayout->addWidget(treeWidget);
+    layout->addWidget(itemViews, 1, 1);
+
+    // menus, sliders, dials and progress bars
+    auto menuBar = new QMenuBar();
+    auto menu = menuBar->addMenu(QStringLiteral("Menu"));
+    menu->addAction(QIcon::fromTheme(QStringLiteral("document-open")), QStringLiteral("Open"));
+    auto checkableAction = menu->addAction(QStringLiteral("Checkable"));
+    checkableAction->setCheckable(true);
+    checkableAction->setChecked(true);
+    menu->addSeparator();
+    menu->addMenu(QStringLiteral("Submenu"))->addAction(QStringLiteral("Item"));
+    menuBar->addMenu(QStringLiteral("Edit"));
+    auto rangesBox = new QGroupBox(QStringLiteral("Ranges"));
+    auto rangesLayout = new QVBoxLayout(rangesBox);
+    rangesLayout->setMenuBar(menuBar);
+    auto slider = new QSlider(Qt::Horizontal);
+    slider->setTickPosition(QSlider::TicksBelow);
+    slider->setValue(40);
+    rangesLayout->addWidget(slider);
+    auto dial = new QDial();
+    dial->setNotchesVisible(true);
+    rangesLayout->addWidget(dial);
+    auto progressBar = new QProgressBar();
+    progressBar->setValue(60);
+    rangesLayout->addWidget(progressBar);
+    layout->addWidget(rangesBox, 2, 0);
+
+    // MDI windows and toolbars
+    auto mdiContainer = new QWidget();
+    auto mdiLayout = new QVBoxLayout(mdiContainer);
+    auto toolBar = new QToolBar();
+    toolBar->addAction(QIcon::fromTheme(QStringLiteral("document-new")), QStringLiteral("New"));
+    toolBar->addAction(QIcon::fromTheme(QStringLiteral("edit-copy")), QStringLiteral("Copy"));
+    toolBar->addSeparator();
+    toolBar->addAction(QIcon::fromTheme(QStringLiteral("configure")), QStringLiteral("Configure"));
+    mdiLayout->addWidget(toolBar);
+    auto mdiArea = new QMdiArea();
+    for (int i = 0; i < 2; i++) {
+        auto subWindow = mdiArea->addSubWindow(new QTextEdit(QStringLiteral("MDI window %1").arg(i)));
+        subWindow->setWindowTitle(QStringLiteral("MDI window %1").arg(i));
+        subWindow->setGeometry(20 + i * 60, 20 + i * 40, 260, 160);
+    }
+    mdiLayout->addWidget(mdiArea);
+    layout->addWidget(mdiContainer, 2, 1);
+
+    m_gallery->show();
+    QCoreApplication::processEvents();
+}
+
+//________________________________________________________________
+qint64 StyleBenchmark::render(qreal devicePixelRatio)
+{
+    QImage image(m_gallery->size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+
+    QElapsedTimer timer;
+    timer.start();
+    QPainter painter(&image);
+    m_gallery->render(&painter);
+    painter.end();
+    return timer.nsecsElapsed();
+}
+
+//________________________________________________________________
+QJsonObject StyleBenchmark::runGallery(qreal devicePixelRatio)
+{
+    // the first render polishes and fills the style's caches; it is reported separately
+    m_style->resetElementTimings();
+    const qint64 firstRender = render(devicePixelRatio);
+
+    m_style->resetElementTimings();
+    QList<qint64> durations;
+    for (int i = 0; i < m_iterations; i++) {
+        durations.append(render(devicePixelRatio));
+    }
+
+    QJsonObject result;
+    result[QStringLiteral("devicePixelRatio")] = devicePixelRatio;
+    result[QStringLiteral("firstRenderUs")] = firstRender / 1000.0;
+    result[QStringLiteral("render")] = BenchmarkTools::summary(durations);
+    result[QStringLiteral("elements")] = m_style->elementTimings();
+    return result;
+}
+
+//________________________________________________________________
+QJsonObject StyleBenchmark::renderAnimationFrames(int msecs)
+{
+    QList<qint64> durations;
+    QElapsedTimer animationTimer;
+    animationTimer.start();
+    while (animationTimer.elapsed() < msecs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 16);
+        durations.append(render(1.0));
+    }
+    return BenchmarkTools::summary(durations);
+}
+
+//________________________________________________________________
+QJsonObject StyleBenchmark::runAnimations()
+{
+    // long enough for any of the style's animations to complete
+    constexpr int animationTime = 500;
+    const QPointF centre = QRectF(m_hoverTarget->rect()).center();
+    const QPointF globalCentre = m_hoverTarget->mapToGlobal(centre);
+
+    QJsonObject result;
+
+    m_style->resetElementTimings();
+    m_hoverTarget->setAttribute(Qt::WA_UnderMouse, true);
+    QEnterEvent enterEvent(centre, centre, globalCentre);
+    QCoreApplication::sendEvent(m_hoverTarget, &enterEvent);
+    result[QStringLiteral("hoverIn")] = renderAnimationFrames(animationTime);
+
+    QMouseEvent pressEvent(QEvent::MouseButtonPress, centre, globalCentre, Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(m_hoverTarget, &pressEvent);
+    result[QStringLiteral("press")] = renderAnimationFrames(animationTime);
+
+    QMouseEvent releaseEvent(QEvent::MouseButtonRelease, centre, globalCentre, Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(m_hoverTarget, &releaseEvent);
+    result[QStringLiteral("release")] = renderAnimationFrames(animationTime);
+
+    m_hoverTarget->setAttribute(Qt::WA_UnderMouse, false);
+    QEvent leaveEvent(QEvent::Leave);
+    QCoreApplication::sendEvent(m_hoverTarget, &leaveEvent);
+    result[QStringLiteral("hoverOut")] = renderAnimationFrames(animationTime);
+
+    m_stackedWidget->setCurrentIndex(1);
+    result[QStringLiteral("stackedWidgetTransition")] = renderAnimationFrames(animationTime);
+    m_stackedWidget->setCurrentIndex(0);
+
+    result[QStringLiteral("elements")] = m_style->elementTimings();
+    return result;
+}
+
+//________________________________________________________________
+QJsonObject StyleBenchmark::runWidgetStateAccess()
+{
+    // the style looks up the altered background state of a tab bar, and of its parents, for each tab it paints, and that of a scroll area's
+    // viewport when painting behind its scrollbars
+    QList<QWidget *> widgets;
+    const QList<QTabBar *> tabBars = m_gallery->findChildren<QTabBar *>();
+    for (QTabBar *tabBar : tabBars) {
+        widgets.append(tabBar);
+    }
+    const QList<QAbstractScrollArea *> scrollAreas = m_gallery->findChildren<QAbstractScrollArea *>();
+    for (QAbstractScrollArea *scrollArea : scrollAreas) {
+        widgets.append(scrollArea);
+    }
+
+    QList<QImage> images;
+    images.reserve(widgets.count());
+    for (const QWidget *widget : std::as_const(widgets)) {
+        images.append(QImage(widget->size(), QImage::Format_ARGB32_Premultiplied));
+    }
+
+    m_style->resetElementTimings();
+    QList<qint64> durations;
+    durations.reserve(m_iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < m_iterations; i++) {
+        timer.start();
+        for (int j = 0; j < widgets.count(); j++) {
+            QPainter painter(&images[j]);
+            widgets.at(j)->render(&painter);
+        }
+        durations.append(timer.nsecsElapsed());
+    }
+
+    QJsonObject result;
+    result[QStringLiteral("widgets")] = widgets.count();
+    result[QStringLiteral("render")] = BenchmarkTools::summary(durations);
+    result[QStringLiteral("elements")] = m_style->elementTimings();
+    result[QStringLiteral("lookups")] = runWidgetStateLookups(widgets);
+    return result;
+}
+
+//___________________________________________________________________
+QJsonObject StyleBenchmark::runWidgetStateLookups(const QList<QWidget *> &widgets)
+{
+    // the lookups hasAlteredBackground makes for each widget and its parents, through the style's WidgetStateTable and, as a baseline, through the
+    // dynamic property it replaced
+    static constexpr char alteredBackgroundProperty[] = "_breeze_altered_background";
+    static constexpr int lookupsPerIteration = 1000;
+
+    QList<QWidget *> chain;
+    for (QWidget *widget : widgets) {
+        for (QWidget *parent = widget; parent; parent = parent->parentWidget()) {
+            chain.append(parent);
+        }
+    }
+
+    WidgetStateTable widgetStates;
+    for (QWidget *widget : std::as_const(chain)) {
+        widget->setProperty(alteredBackgroundProperty, false);
+        widgetStates.setFlags(widget, WidgetStateTable::AlteredBackgroundKnown);
+    }
+
+    int found = 0;
+    QList<qint64> dynamicPropertyDurations;
+    QList<qint64> widgetStateTableDurations;
+    dynamicPropertyDurations.reserve(m_iterations);
+    widgetStateTableDurations.reserve(m_iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < m_iterations; i++) {
+        timer.start();
+        for (int j = 0; j < lookupsPerIteration; j++) {
+            for (const QWidget *widget : std::as_const(chain)) {
+                found += widget->property(alteredBackgroundProperty).isValid();
+            }
+        }
+        dynamicPropertyDurations.append(timer.nsecsElapsed());
+
+        timer.start();
+        for (int j = 0; j < lookupsPerIteration; j++) {
+            for (const QWidget *widget : std::as_const(chain)) {
+                found += widgetStates.testFlag(widget, WidgetStateTable::AlteredBackgroundKnown);
+            }
+        }
+        widgetStateTableDurations.append(timer.nsecsElapsed());
+    }
+
+    for (QWidget *widget : std::as_const(chain)) {
+        widget->setProperty(alteredBackgroundProperty, QVariant());
+    }
+
+    QJsonObject result;
+    result[QStringLiteral("widgets")] = chain.count();
+    result[QStringLiteral("lookupsPerIteration")] = lookupsPerIteration * chain.count();
+    result[QStringLiteral("dynamicProperty")] = BenchmarkTools::summary(dynamicPropertyDurations);
+    result[QStringLiteral("widgetStateTable")] = BenchmarkTools::summary(widgetStateTableDurations);
+    // consumed so that the lookups are not optimised away
+    result[QStringLiteral("found")] = found;
+    return result;
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QPointer>
+#include <QProxyStyle>
+
+class QStackedWidget;
+class QWidget;
+
+namespace Breeze
+{
+
+/**
+ * @brief Wraps the Klassy style's draw dispatchers to time each primitive, control and complex control element
+ *        Timings are inclusive: an element drawn from within another element's drawing through proxy() is counted in both
+ */
+class TimingProxyStyle : public QProxyStyle
+{
+    Q_OBJECT
+
+public:
+    //* takes ownership of \p style
+    explicit TimingProxyStyle(QStyle *style);
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const override;
+    void drawControl(ControlElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const override;
+    void drawComplexControl(ComplexControl control, const QStyleOptionComplex *option, QPainter *painter, const QWidget *widget) const override;
+
+    //* per-element call counts and durations since the last reset, grouped by dispatcher
+    QJsonObject elementTimings() const;
+    void resetElementTimings();
+
+private:
+    struct ElementTiming {
+        int calls = 0;
+        qint64 nsecs = 0;
+    };
+
+    mutable QHash<int, ElementTiming> m_primitiveTimings;
+    mutable QHash<int, ElementTiming> m_controlTimings;
+    mutable QHash<int, ElementTiming> m_complexControlTimings;
+};
+
+/**
+ * @brief Renders a fixed gallery of widgets with the Klassy style, and times the renders and the style's widget animations
+ */
+class StyleBenchmark
+{
+public:
+    StyleBenchmark(TimingProxyStyle *style, int iterations);
+    ~StyleBenchmark();
+
+    //* times rendering the whole gallery at the given device pixel ratio, with the per-element timings
+    QJsonObject runGallery(qreal devicePixelRatio);
+
+    //* times the frames painted during hover, press and stacked widget transition animations
+    QJsonObject runAnimations();
+
+    //* times painting the gallery's tab bars and scroll areas, which look up the style's per-widget altered background state, with the per-element timings
+    // and the lookups alone against a dynamic property baseline
+    QJsonObject runWidgetStateAccess();
+
+private:
+    void createGallery();
+
+    //* times the altered background lookups for the given widgets and their parents, through the WidgetStateTable and through a dynamic property
+    QJsonObject runWidgetStateLookups(const QList<QWidget *> &widgets);
+
+    //* renders the gallery into an image at the given device pixel ratio, returning the time taken in nanoseconds
+    qint64 render(qreal devicePixelRatio);
+
+    //* renders frames while the event loop advances the style's animations for the given time, returning a summary of the frame times
+    QJsonObject renderAnimationFrames(int msecs);
+
+    TimingProxyStyle *m_style;
+    int m_iterations;
+
+    QPointer<QWidget> m_gallery;
+    QPointer<QWidget> m_hoverTarget;
+    QPointer<QStackedWidget> m_stackedWidget;
+};
+
+}
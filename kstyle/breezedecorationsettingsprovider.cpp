@@ -8,6 +8,8 @@
 #include "breezedecorationsettingsprovider.h"
 #include "decorationexceptionlist.h"
 #include "presetsmodel.h"
+#include "settingsskeleton.h"
+#include "settingssnapshot.h"
 
 #include <KWindowInfo>
 
@@ -21,10 +23,9 @@ DecorationSettingsProvider *DecorationSettingsProvider::s_self = nullptr;
 
 //__________________________________________________________________
 DecorationSettingsProvider::DecorationSettingsProvider()
-    : m_config(KSharedConfig::openConfig(QStringLiteral("klassy/klassyrc")))
+    : m_config(KSharedConfigPtr())
     , m_presetsConfig(KSharedConfigPtr())
 {
-    m_defaultSettings = InternalSettingsPtr(new InternalSettings());
 }
 
 //__________________________________________________________________
@@ -47,6 +48,18 @@ DecorationSettingsProvider *DecorationSettingsProvider::self()
 //__________________________________________________________________
 void DecorationSettingsProvider::reconfigure()
 {
+    // the settings tools write a snapshot of the resolved settings, which avoids parsing the exceptions and presets here
+    m_snapshotSettings = SettingsSnapshot::load(qAppName());
+    if (m_snapshotSettings) {
+        m_exceptions.clear();
+        return;
+    }
+
+    // the snapshot is missing or stale, so klassyrc is only opened here
+    if (!m_config) {
+        m_config = KSharedConfig::openConfig(QStringLiteral("klassy/klassyrc"));
+        m_defaultSettings = InternalSettingsPtr(new InternalSettings());
+    }
     m_defaultSettings->load();
 
     DecorationExceptionList exceptions;
@@ -58,6 +71,10 @@ void DecorationSettingsProvider::reconfigure()
 //__________________________________________________________________
 InternalSettingsPtr DecorationSettingsProvider::internalSettings()
 {
+    if (m_snapshotSettings) {
+        return m_snapshotSettings;
+    }
+
     for (auto internalSettings : std::as_const(m_exceptions)) {
         // discard disabled exceptions
         if (!internalSettings->enabled())
@@ -92,6 +109,11 @@ InternalSettingsPtr DecorationSettingsProvider::internalSettings()
         }
     }
 
+    if (!m_defaultSettings) {
+        // not yet reconfigured, so there is nothing to load and klassyrc is not needed
+        SettingsSkeleton::DetachedScope detached;
+        m_defaultSettings = InternalSettingsPtr(new InternalSettings());
+    }
     return m_defaultSettings;
 }
 }
@@ -45,13 +45,16 @@ private:
     //* constructor
     DecorationSettingsProvider();
 
-    //* default configuration
+    //* default configuration, bound to klassyrc once the snapshot could not be used
     InternalSettingsPtr m_defaultSettings;
 
+    //* settings for qApp resolved from the settings snapshot, null if the snapshot could not be used
+    InternalSettingsPtr m_snapshotSettings;
+
     //* exceptions
     InternalSettingsList m_exceptions;
 
-    //* config object
+    //* config object, only opened when the snapshot could not be used
     KSharedConfigPtr m_config;
 
     //* presets config object
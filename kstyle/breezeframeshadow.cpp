@@ -7,6 +7,7 @@
 #include "breezeframeshadow.h"
 
 #include "breezemetrics.h"
+#include "breezewidgetclassification.h"
 
 #include <QAbstractScrollArea>
 #include <QApplication>
@@ -34,24 +35,24 @@ bool FrameShadowFactory::registerWidget(QWidget *widget, Helper &helper)
     // check whether widget is a frame, and has the proper shape
     bool accepted = false;
 
-    // cast to frame and check
-    QFrame *frame(qobject_cast<QFrame *>(widget));
-    if (frame) {
+    // check frame
+    const WidgetClassification::Roles roles = WidgetClassification::roles(widget);
+    if (roles & WidgetClassification::Frame) {
         // also do not install on QSplitter
         /*
         due to Qt, splitters are set with a frame style that matches the condition below,
         though no shadow should be installed, obviously
         */
-        if (qobject_cast<QSplitter *>(widget)) {
+        if (roles & WidgetClassification::Splitter) {
             return false;
         }
 
         // further checks on frame shape, and parent
-        if (frame->frameStyle() == (QFrame::StyledPanel | QFrame::Sunken)) {
+        if (static_cast<QFrame *>(widget)->frameStyle() == (QFrame::StyledPanel | QFrame::Sunken)) {
             accepted = true;
         }
 
-    } else if (widget->inherits("KTextEditor::View")) {
+    } else if (roles & WidgetClassification::KTextEditorView) {
         accepted = true;
     }
 
@@ -62,7 +63,7 @@ bool FrameShadowFactory::registerWidget(QWidget *widget, Helper &helper)
     // make sure that the widget is not embedded into a KHTMLView
     QWidget *parent(widget->parentWidget());
     while (parent && !parent->isTopLevel()) {
-        if (parent->inherits("KHTMLView")) {
+        if (WidgetClassification::is(parent, WidgetClassification::KHTMLView)) {
             return false;
         }
         parent = parent->parentWidget();
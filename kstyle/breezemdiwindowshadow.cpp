@@ -11,6 +11,7 @@
 #include "breezemetrics.h"
 #include "breezesettings.h"
 #include "breezeshadowhelper.h"
+#include "breezewidgetclassification.h"
 
 #include <QMdiArea>
 #include <QMdiSubWindow>
@@ -124,11 +125,11 @@ MdiWindowShadowFactory::MdiWindowShadowFactory(QObject *parent)
 bool MdiWindowShadowFactory::registerWidget(QWidget *widget)
 {
     // check widget type
-    auto subwindow(qobject_cast<QMdiSubWindow *>(widget));
-    if (!subwindow) {
+    if (!WidgetClassification::is(widget, WidgetClassification::MdiSubWindow)) {
         return false;
     }
-    if (subwindow->widget() && subwindow->widget()->inherits("KMainWindow")) {
+    auto subwindow(static_cast<QMdiSubWindow *>(widget));
+    if (WidgetClassification::is(subwindow->widget(), WidgetClassification::KMainWindow)) {
         return false;
     }
 
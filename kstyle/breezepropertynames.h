@@ -16,7 +16,6 @@ struct PropertyNames {
     static const char netWMSkipShadow[];
     static const char sidePanelView[];
     static const char toolButtonAlignment[];
-    static const char alteredBackground[];
     static const char highlightNeutral[];
     static const char noSeparator[];
     static const char isTopMenu[];
@@ -12,6 +12,7 @@
 #include "breezemetrics.h"
 #include "breezepropertynames.h"
 #include "breezesettings.h"
+#include "breezewidgetclassification.h"
 
 #include <KWindowSystem>
 
@@ -258,25 +259,25 @@ void ShadowHelper::windowDeleted(QObject *object)
 //_______________________________________________________
 bool ShadowHelper::isMenu(QWidget *widget) const
 {
-    return qobject_cast<QMenu *>(widget);
+    return WidgetClassification::is(widget, WidgetClassification::Menu);
 }
 
 //_______________________________________________________
 bool ShadowHelper::isToolTip(QWidget *widget) const
 {
-    return widget->inherits("QTipLabel") || (widget->windowFlags() & Qt::WindowType_Mask) == Qt::ToolTip;
+    return WidgetClassification::is(widget, WidgetClassification::ToolTipLabel) || (widget->windowFlags() & Qt::WindowType_Mask) == Qt::ToolTip;
 }
 
 //_______________________________________________________
 bool ShadowHelper::isDockWidget(QWidget *widget) const
 {
-    return qobject_cast<QDockWidget *>(widget);
+    return WidgetClassification::is(widget, WidgetClassification::DockWidget);
 }
 
 //_______________________________________________________
 bool ShadowHelper::isToolBar(QWidget *widget) const
 {
-    return qobject_cast<QToolBar *>(widget);
+    return WidgetClassification::is(widget, WidgetClassification::ToolBar);
 }
 
 //_______________________________________________________
@@ -296,12 +297,12 @@ bool ShadowHelper::acceptWidget(QWidget *widget) const
     }
 
     // combobox dropdown lists
-    if (widget->inherits("QComboBoxPrivateContainer")) {
+    if (WidgetClassification::is(widget, WidgetClassification::ComboBoxPrivateContainer)) {
         return true;
     }
 
     // tooltips
-    if (isToolTip(widget) && !widget->inherits("Plasma::ToolTip")) {
+    if (isToolTip(widget) && !WidgetClassification::is(widget, WidgetClassification::PlasmaToolTip)) {
         return true;
     }
 
@@ -427,7 +428,7 @@ QMargins ShadowHelper::shadowMargins(QWidget *widget) const
                      shadowRect.right() - boxRect.right() - Metrics::Shadow_Overlap + params.offset.x(),
                      shadowRect.bottom() - boxRect.bottom() - Metrics::Shadow_Overlap + params.offset.y());
 
-    if (widget->inherits("QBalloonTip")) {
+    if (WidgetClassification::is(widget, WidgetClassification::BalloonTip)) {
         // Balloon tip needs special margins to deal with the arrow.
         int top = widget->contentsMargins().top();
         int bottom = widget->contentsMargins().bottom();
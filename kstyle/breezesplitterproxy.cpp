@@ -7,6 +7,7 @@
 #include "breezesplitterproxy.h"
 
 #include "breezestyleconfigdata.h"
+#include "breezewidgetclassification.h"
 
 #include <QCoreApplication>
 #include <QDebug>
@@ -57,7 +58,8 @@ void SplitterFactory::setEnabled(bool value)
 bool SplitterFactory::registerWidget(QWidget *widget)
 {
     // check widget type
-    if (qobject_cast<QMainWindow *>(widget)) {
+    const WidgetClassification::Roles roles = WidgetClassification::roles(widget);
+    if (roles & WidgetClassification::MainWindow) {
         WidgetMap::iterator iter(_widgets.find(widget));
         if (iter == _widgets.end() || !iter.value()) {
             widget->installEventFilter(&_addEventFilter);
@@ -74,7 +76,7 @@ bool SplitterFactory::registerWidget(QWidget *widget)
 
         return true;
 
-    } else if (qobject_cast<QSplitterHandle *>(widget)) {
+    } else if (roles & WidgetClassification::SplitterHandle) {
         QWidget *window(widget->window());
         WidgetMap::iterator iter(_widgets.find(window));
         if (iter == _widgets.end() || !iter.value()) {
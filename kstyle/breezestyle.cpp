@@ -18,10 +18,13 @@
 #include "breezesplitterproxy.h"
 #include "breezestyleconfigdata.h"
 #include "breezetoolsareamanager.h"
+#include "breezewidgetclassification.h"
 #include "breezewidgetexplorer.h"
+#include "breezewidgetstatetable.h"
 #include "breezewindowmanager.h"
 #include "dbusupdatenotifier.h"
 #include "decorationcolors.h"
+#include "tracing.h"
 
 #include <KColorUtils>
 #include <KIconLoader>
@@ -242,7 +245,8 @@ Style::Style()
     , _frameShadowFactory(new FrameShadowFactory(this))
     , _mdiWindowShadowFactory(new MdiWindowShadowFactory(this))
     , _splitterFactory(new SplitterFactory(this))
-    , _toolsAreaManager(new ToolsAreaManager(_helper, this))
+    , _widgetStates(new WidgetStateTable(this))
+    , _toolsAreaManager(new ToolsAreaManager(_helper, _widgetStates, this))
     , _widgetExplorer(new WidgetExplorer(this))
     , _tabBarData(new BreezePrivate::TabBarData(this))
 #if BREEZE_HAVE_KSTYLE
@@ -275,7 +279,7 @@ Style::Style()
                  this,
                  SLOT(configurationChanged()));
 
-    connect(&g_dBusUpdateNotifier, &DBusUpdateNotifier::decorationSettingsUpdate, this, &Style::generateDecorationColorsOnDecorationColorSettingsUpdate);
+    connect(DBusUpdateNotifier::self(), &DBusUpdateNotifier::decorationSettingsUpdate, this, &Style::generateDecorationColorsOnDecorationColorSettingsUpdate);
 
     // dbus.connect(QString(), QStringLiteral("/KWin"), QStringLiteral("org.kde.KWin"), QStringLiteral("reloadConfig"), this, SLOT(configurationChanged()));
 
@@ -290,7 +294,7 @@ Style::Style()
     // need to be reset when the system palette changes
     loadConfiguration();
 
-    connect(&g_dBusUpdateNotifier,
+    connect(DBusUpdateNotifier::self(),
             &DBusUpdateNotifier::systemIconsUpdate,
             this,
             [this]() { // call this after loadConfiguration() as _helper->decorationConfig() needs to be initialized properly first
@@ -324,11 +328,7 @@ void Style::polish(QWidget *widget)
     _toolsAreaManager->registerWidget(widget);
 
     // enable mouse over effects for all necessary widgets
-    if (qobject_cast<QAbstractItemView *>(widget) || qobject_cast<QAbstractSpinBox *>(widget) || qobject_cast<QCheckBox *>(widget)
-        || qobject_cast<QComboBox *>(widget) || qobject_cast<QDial *>(widget) || qobject_cast<QLineEdit *>(widget) || qobject_cast<QPushButton *>(widget)
-        || qobject_cast<QRadioButton *>(widget) || qobject_cast<QScrollBar *>(widget) || qobject_cast<QSlider *>(widget)
-        || qobject_cast<QSplitterHandle *>(widget) || qobject_cast<QTabBar *>(widget) || qobject_cast<QTextEdit *>(widget)
-        || qobject_cast<QToolButton *>(widget) || widget->inherits("KTextEditor::View")) {
+    if (WidgetClassification::is(widget, WidgetClassification::HoverRoles)) {
         widget->setAttribute(Qt::WA_Hover);
     }
 
@@ -376,7 +376,7 @@ void Style::polish(QWidget *widget)
         }
 
         if (widget->parentWidget() && widget->parentWidget()->parentWidget() && widget->parentWidget()->parentWidget()->inherits("Gwenview::SideBarGroup")) {
-            widget->setProperty(PropertyNames::toolButtonAlignment, Qt::AlignLeft);
+            _widgetStates->setFlags(widget, WidgetStateTable::ToolButtonAlignLeft);
         }
 
     } else if (qobject_cast<QDockWidget *>(widget)) {
@@ -554,6 +554,7 @@ void Style::unpolish(QWidget *widget)
     _splitterFactory->unregisterWidget(widget);
     _blurHelper->unregisterWidget(widget);
     _toolsAreaManager->unregisterWidget(widget);
+    _scrollAreaStructures.remove(widget);
 
     // remove event filter
     if (qobject_cast<QAbstractScrollArea *>(widget) || qobject_cast<QDockWidget *>(widget) || qobject_cast<QMdiSubWindow *>(widget)
@@ -1034,6 +1035,7 @@ QStyle::SubControl Style::hitTestComplexControl(ComplexControl control, const QS
 //______________________________________________________________
 void Style::drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const
 {
+    KLASSY_TRACE_SCOPE_ARG("style", "Style::drawPrimitive", "element", element);
     StylePrimitive fcn;
     switch (element) {
     case PE_PanelButtonCommand:
@@ -1159,6 +1161,7 @@ bool Style::drawWidgetPrimitive(const QStyleOption *option, QPainter *painter, c
 //______________________________________________________________
 void Style::drawControl(ControlElement element, const QStyleOption *option, QPainter *painter, const QWidget *widget) const
 {
+    KLASSY_TRACE_SCOPE_ARG("style", "Style::drawControl", "element", element);
     StyleControl fcn;
 
 #if BREEZE_HAVE_KSTYLE
@@ -1279,6 +1282,7 @@ void Style::drawControl(ControlElement element, const QStyleOption *option, QPai
 //______________________________________________________________
 void Style::drawComplexControl(ComplexControl element, const QStyleOptionComplex *option, QPainter *painter, const QWidget *widget) const
 {
+    KLASSY_TRACE_SCOPE_ARG("style", "Style::drawComplexControl", "element", element);
     StyleComplexControl fcn;
     switch (element) {
     case CC_GroupBox:
@@ -1465,9 +1469,10 @@ bool Style::eventFilter(QObject *object, QEvent *event)
 
     if (object->isWidgetType()) {
         QWidget *widget = static_cast<QWidget *>(object);
-        if (widget->inherits("QAbstractScrollArea") || widget->inherits("KTextEditor::View")) {
+        const WidgetClassification::Roles roles = WidgetClassification::roles(widget);
+        if (roles & (WidgetClassification::AbstractScrollArea | WidgetClassification::KTextEditorView)) {
             return eventFilterScrollArea(widget, event);
-        } else if (widget->inherits("QComboBoxPrivateContainer")) {
+        } else if (roles & WidgetClassification::ComboBoxPrivateContainer) {
             return eventFilterComboBoxContainer(widget, event);
         }
 
@@ -1523,17 +1528,18 @@ bool Style::eventFilterScrollArea(QWidget *widget, QEvent *event)
         }
 
         // get scrollarea horizontal and vertical containers
-        QWidget *child(nullptr);
-        QList<QWidget *> children;
-        if ((child = scrollArea->findChild<QWidget *>("qt_scrollarea_vcontainer")) && child->isVisible()) {
-            children.append(child);
+        const ScrollAreaStructure &structure(scrollAreaStructure(scrollArea));
+        QWidget *children[2];
+        int childCount(0);
+        if (structure.verticalContainer && structure.verticalContainer->isVisible()) {
+            children[childCount++] = structure.verticalContainer;
         }
 
-        if ((child = scrollArea->findChild<QWidget *>("qt_scrollarea_hcontainer")) && child->isVisible()) {
-            children.append(child);
+        if (structure.horizontalContainer && structure.horizontalContainer->isVisible()) {
+            children[childCount++] = structure.horizontalContainer;
         }
 
-        if (children.empty()) {
+        if (childCount == 0) {
             break;
         }
         if (!scrollArea->styleSheet().isEmpty()) {
@@ -1557,8 +1563,8 @@ bool Style::eventFilterScrollArea(QWidget *widget, QEvent *event)
         painter.setBrush(background);
 
         // render
-        for (auto *child : std::as_const(children)) {
-            painter.drawRect(child->geometry());
+        for (int i = 0; i < childCount; ++i) {
+            painter.drawRect(children[i]->geometry());
         }
 
     } break;
@@ -1572,22 +1578,25 @@ bool Style::eventFilterScrollArea(QWidget *widget, QEvent *event)
         // get frame framewidth
         const int frameWidth(pixelMetric(PM_DefaultFrameWidth, nullptr, widget));
 
-        // find list of scrollbars
-        QList<QScrollBar *> scrollBars;
+        // find scrollbars
+        QScrollBar *scrollAreaScrollBars[2] = {nullptr, nullptr};
+        const QList<QPointer<QScrollBar>> *viewScrollBars(nullptr);
         if (auto scrollArea = qobject_cast<QAbstractScrollArea *>(widget)) {
             if (scrollArea->horizontalScrollBarPolicy() != Qt::ScrollBarAlwaysOff) {
-                scrollBars.append(scrollArea->horizontalScrollBar());
+                scrollAreaScrollBars[0] = scrollArea->horizontalScrollBar();
             }
             if (scrollArea->verticalScrollBarPolicy() != Qt::ScrollBarAlwaysOff) {
-                scrollBars.append(scrollArea->verticalScrollBar());
+                scrollAreaScrollBars[1] = scrollArea->verticalScrollBar();
             }
 
-        } else if (widget->inherits("KTextEditor::View")) {
-            scrollBars = widget->findChildren<QScrollBar *>();
+        } else {
+            viewScrollBars = &scrollAreaStructure(widget).scrollBars;
         }
 
         // loop over found scrollbars
-        for (QScrollBar *scrollBar : std::as_const(scrollBars)) {
+        const int scrollBarCount(viewScrollBars ? viewScrollBars->count() : 2);
+        for (int i = 0; i < scrollBarCount; ++i) {
+            QScrollBar *scrollBar(viewScrollBars ? viewScrollBars->at(i).data() : scrollAreaScrollBars[i]);
             if (!(scrollBar && scrollBar->isVisible())) {
                 continue;
             }
@@ -1618,6 +1627,17 @@ bool Style::eventFilterScrollArea(QWidget *widget, QEvent *event)
         break;
     }
 
+    case QEvent::ChildAdded:
+    case QEvent::ChildRemoved:
+    case QEvent::Show: {
+        // children have changed, so look them up again on next use
+        auto iter(_scrollAreaStructures.find(widget));
+        if (iter != _scrollAreaStructures.end()) {
+            iter.value().resolved = false;
+        }
+        break;
+    }
+
     default:
         break;
     }
@@ -1625,6 +1645,42 @@ bool Style::eventFilterScrollArea(QWidget *widget, QEvent *event)
     return ParentStyleClass::eventFilter(widget, event);
 }
 
+//____________________________________________________________________________
+const Style::ScrollAreaStructure &Style::scrollAreaStructure(QWidget *widget)
+{
+    auto iter(_scrollAreaStructures.find(widget));
+    if (iter == _scrollAreaStructures.end()) {
+        iter = _scrollAreaStructures.insert(widget, ScrollAreaStructure());
+        // unique, as unpolish removes the structure but the widget can be polished again
+        connect(widget, &QObject::destroyed, this, &Style::scrollAreaDestroyed, Qt::UniqueConnection);
+    }
+
+    ScrollAreaStructure &structure(iter.value());
+    if (!structure.resolved) {
+        // the containers are direct children of the scroll area
+        structure.verticalContainer = widget->findChild<QWidget *>(QStringLiteral("qt_scrollarea_vcontainer"), Qt::FindDirectChildrenOnly);
+        structure.horizontalContainer = widget->findChild<QWidget *>(QStringLiteral("qt_scrollarea_hcontainer"), Qt::FindDirectChildrenOnly);
+
+        structure.scrollBars.clear();
+        if (WidgetClassification::is(widget, WidgetClassification::KTextEditorView)) {
+            const QList<QScrollBar *> scrollBars(widget->findChildren<QScrollBar *>());
+            for (QScrollBar *scrollBar : scrollBars) {
+                structure.scrollBars.append(scrollBar);
+            }
+        }
+
+        structure.resolved = true;
+    }
+
+    return structure;
+}
+
+//____________________________________________________________________________
+void Style::scrollAreaDestroyed(QObject *object)
+{
+    _scrollAreaStructures.remove(object);
+}
+
 //_________________________________________________________
 bool Style::eventFilterComboBoxContainer(QWidget *widget, QEvent *event)
 {
@@ -5121,7 +5177,10 @@ bool Style::drawToolButtonLabelControl(const QStyleOption *option, QPainter *pai
 
         textFlags |= Qt::AlignCenter;
     } else if (hasIcon && hasText) {
-        const bool leftAlign(widget && widget->property(PropertyNames::toolButtonAlignment).toInt() == Qt::AlignLeft);
+        // the alignment is either set by the style when polishing, or by the application through the property
+        const bool leftAlign(widget
+                             && (_widgetStates->testFlag(widget, WidgetStateTable::ToolButtonAlignLeft)
+                                 || widget->property(PropertyNames::toolButtonAlignment).toInt() == Qt::AlignLeft));
         if (leftAlign) {
             const int marginWidth(Metrics::Button_MarginWidth + Metrics::Frame_FrameWidth + 1);
             iconRect = {
@@ -8190,10 +8249,10 @@ bool Style::hasAlteredBackground(const QWidget *widget) const
         return false;
     }
 
-    // check property
-    const QVariant property(widget->property(PropertyNames::alteredBackground));
-    if (property.isValid()) {
-        return property.toBool();
+    // check cached state
+    const WidgetStateTable::Flags flags(_widgetStates->flags(widget));
+    if (flags.testFlag(WidgetStateTable::AlteredBackgroundKnown)) {
+        return flags.testFlag(WidgetStateTable::AlteredBackground);
     }
 
     // check if widget is of relevant type
@@ -8211,7 +8270,9 @@ bool Style::hasAlteredBackground(const QWidget *widget) const
     if (widget->parentWidget() && !hasAlteredBackground) {
         hasAlteredBackground = this->hasAlteredBackground(widget->parentWidget());
     }
-    const_cast<QWidget *>(widget)->setProperty(PropertyNames::alteredBackground, hasAlteredBackground);
+    _widgetStates->setFlags(widget,
+                            hasAlteredBackground ? WidgetStateTable::AlteredBackgroundKnown | WidgetStateTable::AlteredBackground
+                                                 : WidgetStateTable::Flags(WidgetStateTable::AlteredBackgroundKnown));
     return hasAlteredBackground;
 }
 
@@ -25,6 +25,8 @@
 #include <QHash>
 #include <QIcon>
 #include <QMdiSubWindow>
+#include <QPointer>
+#include <QScrollBar>
 #include <QStyleOption>
 #include <QWidget>
 
@@ -46,6 +48,7 @@ class Mnemonics;
 class ShadowHelper;
 class SplitterFactory;
 class WidgetExplorer;
+class WidgetStateTable;
 class WindowManager;
 class BlurHelper;
 class ToolsAreaManager;
@@ -156,6 +159,9 @@ protected Q_SLOTS:
     //* set flag to regenerate cache of decorationColors and update configuration
     void generateDecorationColorsOnDecorationColorSettingsUpdate(QByteArray uuid);
 
+    //* remove the structure of a destroyed scroll area
+    void scrollAreaDestroyed(QObject *);
+
 protected:
     //* standard icons
     QIcon standardIcon(StandardPixmap pixmap, const QStyleOption *option = nullptr, const QWidget *widget = nullptr) const override
@@ -515,6 +521,9 @@ private:
     //* splitter Factory, to extend splitters hit area
     SplitterFactory *_splitterFactory = nullptr;
 
+    //* per-widget state computed by the style
+    WidgetStateTable *_widgetStates = nullptr;
+
     //* signal manager for the tools area
     ToolsAreaManager *_toolsAreaManager = nullptr;
 
@@ -528,6 +537,24 @@ private:
     using IconCache = QHash<StandardPixmap, QIcon>;
     IconCache _iconCache;
 
+    //* children of a filtered scroll area or KTextEditor view which its event filter acts on
+    // the structure is only invalidated by children being added to or removed from the widget itself, or by it being shown, so a scrollbar
+    // added deeper inside a KTextEditor view is only picked up on the view's next ChildAdded, ChildRemoved or Show event
+    struct ScrollAreaStructure {
+        //* false once the children have changed, so they are looked up again on next use
+        bool resolved = false;
+        QPointer<QWidget> verticalContainer;
+        QPointer<QWidget> horizontalContainer;
+        //* scrollbars of a KTextEditor view, which are not reachable through the QAbstractScrollArea API
+        QList<QPointer<QScrollBar>> scrollBars;
+    };
+
+    //* the resolved structure of the given scroll area or KTextEditor view, resolving it first if needed
+    const ScrollAreaStructure &scrollAreaStructure(QWidget *);
+
+    //* resolved scroll area structures
+    QHash<const QObject *, ScrollAreaStructure> _scrollAreaStructures;
+
     //* pointer to primitive specialized function
     using StylePrimitive = std::function<bool(const Style &, const QStyleOption *, QPainter *, const QWidget *)>;
     StylePrimitive _frameFocusPrimitive;
@@ -1,5 +1,6 @@
 #include "breezetoolsareamanager.h"
 #include "breezepropertynames.h"
+#include "breezewidgetclassification.h"
 
 #include <QMainWindow>
 #include <QMdiArea>
@@ -15,9 +16,10 @@ const char *colorProperty = "KDE_COLOR_SCHEME_PATH";
 
 namespace Breeze
 {
-ToolsAreaManager::ToolsAreaManager(Helper *helper, QObject *parent)
+ToolsAreaManager::ToolsAreaManager(Helper *helper, WidgetStateTable *widgetStates, QObject *parent)
     : QObject(parent)
     , _helper(helper)
+    , _widgetStates(widgetStates)
 {
 }
 
@@ -38,20 +40,23 @@ void appendIfNotAlreadyExists(T1 *list, T2 item)
 
 void ToolsAreaManager::doTranslucency(QMainWindow *win, bool on)
 {
-    QVariant wasTranslucent = win->property("_klassy_was_translucent");
+    const WidgetStateTable::Flags flags(_widgetStates->flags(win));
 
     if (on) {
-        if (wasTranslucent.isValid()) // if translucency has already been set here then don't set it again
+        if (flags.testFlag(WidgetStateTable::TranslucencyChanged)) // if translucency has already been set here then don't set it again
             return;
 
-        win->setProperty("_klassy_was_translucent", win->testAttribute(Qt::WA_TranslucentBackground));
+        _widgetStates->setFlags(win,
+                                win->testAttribute(Qt::WA_TranslucentBackground) ? WidgetStateTable::TranslucencyChanged | WidgetStateTable::WasTranslucent
+                                                                                 : WidgetStateTable::Flags(WidgetStateTable::TranslucencyChanged));
         win->setAttribute(Qt::WA_TranslucentBackground, true);
     } else {
-        if (!wasTranslucent.isValid()) // do not turn off translucency if it was initially set by a third party
+        if (!flags.testFlag(WidgetStateTable::TranslucencyChanged)) // do not turn off translucency if it was initially set by a third party
             return;
 
-        win->setAttribute(Qt::WA_TranslucentBackground, wasTranslucent.toBool()); // set the translucency back to its initial value if altered here
-        win->setProperty("_klassy_was_translucent", QVariant());
+        win->setAttribute(Qt::WA_TranslucentBackground,
+                          flags.testFlag(WidgetStateTable::WasTranslucent)); // set the translucency back to its initial value if altered here
+        _widgetStates->setFlags(win, WidgetStateTable::Flags(), WidgetStateTable::TranslucencyChanged | WidgetStateTable::WasTranslucent);
     }
 }
 
@@ -264,11 +269,12 @@ void ToolsAreaManager::registerWidget(QWidget *widget)
     auto parent = ptr;
     QPointer<QMainWindow> mainWindow = nullptr;
     while (parent != nullptr) {
-        if (qobject_cast<QMdiArea *>(parent) || qobject_cast<QDockWidget *>(parent)) {
+        const WidgetClassification::Roles roles = WidgetClassification::roles(parent);
+        if (roles & (WidgetClassification::MdiArea | WidgetClassification::DockWidget)) {
             break;
         }
-        if (qobject_cast<QMainWindow *>(parent)) {
-            mainWindow = qobject_cast<QMainWindow *>(parent);
+        if (roles & WidgetClassification::MainWindow) {
+            mainWindow = static_cast<QMainWindow *>(parent.data());
         }
         parent = parent->parentWidget();
     }
@@ -2,6 +2,7 @@
 
 #include "breezehelper.h"
 #include "breezestyle.h"
+#include "breezewidgetstatetable.h"
 #include <KSharedConfig>
 #include <QApplication>
 #include <QObject>
@@ -32,6 +33,7 @@ class ToolsAreaManager : public QObject
 private:
     void doTranslucency(QMainWindow *win, bool on);
     Helper *_helper;
+    WidgetStateTable *_widgetStates;
     QHash<const QMainWindow *, QVector<QPointer<QToolBar>>> _windows;
     KSharedConfigPtr _config;
     QPalette _palette = QPalette();
@@ -46,7 +48,7 @@ protected:
     void tryUnregisterToolBar(QPointer<QMainWindow> window, QPointer<QWidget> widget);
 
 public:
-    explicit ToolsAreaManager(Helper *helper, QObject *parent = nullptr);
+    explicit ToolsAreaManager(Helper *helper, WidgetStateTable *widgetStates, QObject *parent = nullptr);
     ~ToolsAreaManager();
 
     void configUpdated();
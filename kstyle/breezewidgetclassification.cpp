@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "breezewidgetclassification.h"
+
+#include <QAbstractItemView>
+#include <QAbstractScrollArea>
+#include <QAbstractSpinBox>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDial>
+#include <QDialog>
+#include <QDockWidget>
+#include <QFrame>
+#include <QGraphicsView>
+#include <QGroupBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QMainWindow>
+#include <QMdiArea>
+#include <QMdiSubWindow>
+#include <QMenu>
+#include <QMenuBar>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QRadioButton>
+#include <QScrollBar>
+#include <QSlider>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QStackedWidget>
+#include <QStatusBar>
+#include <QTabBar>
+#include <QTextEdit>
+#include <QToolBar>
+#include <QToolButton>
+#include <QTreeView>
+
+#include <cstring>
+
+namespace Breeze
+{
+
+QHash<const QMetaObject *, WidgetClassification::ClassRoles> WidgetClassification::s_roles;
+
+//* classes which can be identified by their static meta object
+struct MetaObjectRole {
+    const QMetaObject *metaObject;
+    WidgetClassification::Role role;
+};
+
+//* classes from other libraries, or private to Qt, which can only be identified by name
+struct ClassNameRole {
+    const char *className;
+    WidgetClassification::Role role;
+};
+
+//____________________________________________________________________
+WidgetClassification::Roles WidgetClassification::roles(const QObject *object)
+{
+    if (!object) {
+        return None;
+    }
+
+    const QMetaObject *metaObject = object->metaObject();
+    const auto iter = s_roles.constFind(metaObject);
+    if (iter != s_roles.cend() && iter->className == metaObject->className()) {
+        return iter->roles;
+    }
+
+    // not seen yet, or the meta object of an unloaded class has been reused
+    const Roles roles = classify(metaObject);
+    s_roles.insert(metaObject, {QByteArray(metaObject->className()), roles});
+    return roles;
+}
+
+//____________________________________________________________________
+WidgetClassification::Roles WidgetClassification::classify(const QMetaObject *metaObject)
+{
+    static const MetaObjectRole metaObjectRoles[] = {
+        {&QAbstractButton::staticMetaObject, AbstractButton},
+        {&QToolButton::staticMetaObject, ToolButton},
+        {&QPushButton::staticMetaObject, PushButton},
+        {&QCheckBox::staticMetaObject, CheckBox},
+        {&QRadioButton::staticMetaObject, RadioButton},
+        {&QGroupBox::staticMetaObject, GroupBox},
+        {&QScrollBar::staticMetaObject, ScrollBar},
+        {&QSlider::staticMetaObject, Slider},
+        {&QDial::staticMetaObject, Dial},
+        {&QProgressBar::staticMetaObject, ProgressBar},
+        {&QComboBox::staticMetaObject, ComboBox},
+        {&QAbstractSpinBox::staticMetaObject, AbstractSpinBox},
+        {&QSpinBox::staticMetaObject, SpinBox},
+        {&QLineEdit::staticMetaObject, LineEdit},
+        {&QTextEdit::staticMetaObject, TextEdit},
+        {&QHeaderView::staticMetaObject, HeaderView},
+        {&QAbstractItemView::staticMetaObject, AbstractItemView},
+        {&QTabBar::staticMetaObject, TabBar},
+        {&QAbstractScrollArea::staticMetaObject, AbstractScrollArea},
+        {&QStackedWidget::staticMetaObject, StackedWidget},
+        {&QFrame::staticMetaObject, Frame},
+        {&QSplitter::staticMetaObject, Splitter},
+        {&QSplitterHandle::staticMetaObject, SplitterHandle},
+        {&QMdiArea::staticMetaObject, MdiArea},
+        {&QMdiSubWindow::staticMetaObject, MdiSubWindow},
+        {&QListView::staticMetaObject, ListView},
+        {&QTreeView::staticMetaObject, TreeView},
+        {&QGraphicsView::staticMetaObject, GraphicsView},
+        {&QLabel::staticMetaObject, Label},
+        {&QDialog::staticMetaObject, Dialog},
+        {&QMainWindow::staticMetaObject, MainWindow},
+        {&QMenu::staticMetaObject, Menu},
+        {&QMenuBar::staticMetaObject, MenuBar},
+        {&QStatusBar::staticMetaObject, StatusBar},
+        {&QToolBar::staticMetaObject, ToolBar},
+        {&QDockWidget::staticMetaObject, DockWidget},
+    };
+
+    static const ClassNameRole classNameRoles[] = {
+        {"KTextEditor::View", KTextEditorView},
+        {"KHTMLView", KHTMLView},
+        {"KMainWindow", KMainWindow},
+        {"QQuickWidget", QuickWidget},
+        {"KScreenSaver", KScreenSaver},
+        {"KCModule", KCModule},
+        {"QTipLabel", ToolTipLabel},
+        {"Plasma::ToolTip", PlasmaToolTip},
+        {"QBalloonTip", BalloonTip},
+        {"QComboBoxPrivateContainer", ComboBoxPrivateContainer},
+    };
+
+    // walk the class hierarchy, as both qobject_cast and QObject::inherits do
+    Roles roles = None;
+    for (const QMetaObject *current = metaObject; current; current = current->superClass()) {
+        for (const auto &metaObjectRole : metaObjectRoles) {
+            if (current == metaObjectRole.metaObject) {
+                roles |= metaObjectRole.role;
+            }
+        }
+
+        const char *className = current->className();
+        for (const auto &classNameRole : classNameRoles) {
+            if (std::strcmp(className, classNameRole.className) == 0) {
+                roles |= classNameRole.role;
+            }
+        }
+    }
+
+    return roles;
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMetaObject>
+#include <QObject>
+
+namespace Breeze
+{
+
+/**
+ * @brief Classifies widgets into a bitmask of the types which the style and its managers act on when polishing.
+ *        The classification is computed once per QMetaObject, by walking the class hierarchy, and cached for the lifetime of the process,
+ *        so that polishing a widget replaces chains of qobject_cast and string-based inherits() calls with a hash lookup.
+ *        Cached entries are checked against the class name, as the meta object of a class from an unloaded plugin can be reused by another class.
+ *        A role is set if the class is, or inherits from, the corresponding class, exactly as qobject_cast or QObject::inherits would report.
+ */
+class WidgetClassification
+{
+public:
+    //* bitmask of roles
+    using Roles = quint64;
+
+    enum Role : quint64 {
+        None = 0,
+
+        // buttons
+        AbstractButton = 1ULL << 0,
+        ToolButton = 1ULL << 1,
+        PushButton = 1ULL << 2,
+        CheckBox = 1ULL << 3,
+        RadioButton = 1ULL << 4,
+        GroupBox = 1ULL << 5,
+
+        // sliders and progress
+        ScrollBar = 1ULL << 6,
+        Slider = 1ULL << 7,
+        Dial = 1ULL << 8,
+        ProgressBar = 1ULL << 9,
+
+        // inputs
+        ComboBox = 1ULL << 10,
+        AbstractSpinBox = 1ULL << 11,
+        SpinBox = 1ULL << 12,
+        LineEdit = 1ULL << 13,
+        TextEdit = 1ULL << 14,
+        KTextEditorView = 1ULL << 15,
+
+        // views and containers
+        HeaderView = 1ULL << 16,
+        AbstractItemView = 1ULL << 17,
+        TabBar = 1ULL << 18,
+        AbstractScrollArea = 1ULL << 19,
+        StackedWidget = 1ULL << 20,
+        Frame = 1ULL << 21,
+        Splitter = 1ULL << 22,
+        SplitterHandle = 1ULL << 23,
+        MdiArea = 1ULL << 24,
+        MdiSubWindow = 1ULL << 25,
+        KHTMLView = 1ULL << 26,
+        ListView = 1ULL << 27,
+        TreeView = 1ULL << 28,
+        GraphicsView = 1ULL << 29,
+        Label = 1ULL << 30,
+
+        // windows and window furniture
+        Dialog = 1ULL << 31,
+        MainWindow = 1ULL << 32,
+        KMainWindow = 1ULL << 33,
+        Menu = 1ULL << 34,
+        MenuBar = 1ULL << 35,
+        StatusBar = 1ULL << 36,
+        ToolBar = 1ULL << 37,
+        DockWidget = 1ULL << 38,
+        QuickWidget = 1ULL << 39,
+        KScreenSaver = 1ULL << 40,
+        KCModule = 1ULL << 41,
+
+        // popups
+        ToolTipLabel = 1ULL << 42,
+        PlasmaToolTip = 1ULL << 43,
+        BalloonTip = 1ULL << 44,
+        ComboBoxPrivateContainer = 1ULL << 45,
+    };
+
+    //* widgets which have mouse over effects
+    static constexpr Roles HoverRoles = AbstractItemView | AbstractSpinBox | CheckBox | ComboBox | Dial | LineEdit | PushButton | RadioButton | ScrollBar
+        | Slider | SplitterHandle | TabBar | TextEdit | ToolButton | KTextEditorView;
+
+    //* roles of the given object, None for a null object
+    static Roles roles(const QObject *object);
+
+    //* true if the given object has any of the given roles
+    static bool is(const QObject *object, Roles roles)
+    {
+        return WidgetClassification::roles(object) & roles;
+    }
+
+private:
+    //* compute the roles of a class from its hierarchy
+    static Roles classify(const QMetaObject *metaObject);
+
+    struct ClassRoles {
+        //* name of the class the roles were computed for
+        QByteArray className;
+        Roles roles = None;
+    };
+
+    //* roles per class
+    static QHash<const QMetaObject *, ClassRoles> s_roles;
+};
+
+}
@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "breezewidgetstatetable.h"
+
+namespace Breeze
+{
+
+//____________________________________________________________________
+WidgetStateTable::WidgetStateTable(QObject *parent)
+    : QObject(parent)
+{
+}
+
+//____________________________________________________________________
+void WidgetStateTable::setFlags(const QObject *widget, Flags set, Flags clear)
+{
+    if (!widget) {
+        return;
+    }
+
+    auto iter = _flags.find(widget);
+    if (iter == _flags.end()) {
+        // catch object destruction the first time the widget is seen
+        iter = _flags.insert(widget, Flags());
+        connect(widget, &QObject::destroyed, this, &WidgetStateTable::widgetDestroyed);
+    }
+
+    iter.value() = (iter.value() & ~clear) | set;
+}
+
+//____________________________________________________________________
+void WidgetStateTable::widgetDestroyed(QObject *object)
+{
+    _flags.remove(object);
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+
+namespace Breeze
+{
+
+/**
+ * @brief Per-widget state which the style computes and reads back itself, stored as packed flags keyed by widget.
+ *        Replaces dynamic properties for state private to the style, which cost a scan of the widget's property names and a QVariant per lookup.
+ *        Properties which applications set to influence the style are still read from the widget, as they are public API.
+ *        Entries are removed when their widget is destroyed.
+ */
+class WidgetStateTable : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Flag {
+        //* hasAlteredBackground has been computed for the widget
+        AlteredBackgroundKnown = 1 << 0,
+        //* the widget, or one of its parents, has an altered background
+        AlteredBackground = 1 << 1,
+        //* the style aligns the tool button's icon and text to the left
+        ToolButtonAlignLeft = 1 << 2,
+        //* the tools area manager has made the window translucent
+        TranslucencyChanged = 1 << 3,
+        //* the window was translucent before the tools area manager changed it
+        WasTranslucent = 1 << 4,
+    };
+    Q_DECLARE_FLAGS(Flags, Flag)
+
+    //* constructor
+    explicit WidgetStateTable(QObject *parent = nullptr);
+
+    //* flags of the given widget, none if it has no entry
+    Flags flags(const QObject *widget) const
+    {
+        return _flags.value(widget);
+    }
+
+    //* true if the given flag is set for the widget
+    bool testFlag(const QObject *widget, Flag flag) const
+    {
+        return flags(widget).testFlag(flag);
+    }
+
+    //* set and clear flags of the given widget, creating its entry if needed
+    void setFlags(const QObject *widget, Flags set, Flags clear = Flags());
+
+    //* number of widgets with an entry
+    int count() const
+    {
+        return _flags.count();
+    }
+
+private Q_SLOTS:
+    //* remove the entry of a destroyed widget
+    void widgetDestroyed(QObject *);
+
+private:
+    QHash<const QObject *, Flags> _flags;
+};
+
+}
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Breeze::WidgetStateTable::Flags)
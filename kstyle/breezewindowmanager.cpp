@@ -12,6 +12,7 @@
 #include "breezewindowmanager.h"
 #include "breezehelper.h"
 #include "breezepropertynames.h"
+#include "breezewidgetclassification.h"
 
 #include <QComboBox>
 #include <QDialog>
@@ -146,12 +147,13 @@ void WindowManager::initialize()
 
     initializeWhiteList();
     initializeBlackList();
+    compileLists();
 }
 
 //_____________________________________________________________
 void WindowManager::registerWidget(QWidget *widget)
 {
-    if (isBlackListed(widget) || isDragable(widget) || widget->inherits("QQuickWidget")) {
+    if (isBlackListed(widget) || isDragable(widget) || WidgetClassification::is(widget, WidgetClassification::QuickWidget)) {
         /*
         install filter for dragable widgets.
         also install filter for blacklisted widgets
@@ -219,6 +221,60 @@ void WindowManager::initializeBlackList()
     }
 }
 
+//_____________________________________________________________
+void WindowManager::compileLists()
+{
+    const auto appName(qApp->applicationName());
+    _listsAppName = appName;
+    _whiteListClassNames.clear();
+    _blackListClassNames.clear();
+    _blackListAll = false;
+    _classListStates.clear();
+
+    for (const ExceptionId &id : std::as_const(_whiteList)) {
+        if (id.appName().isEmpty() || id.appName() == appName) {
+            _whiteListClassNames.insert(id.className().toLatin1());
+        }
+    }
+
+    for (const ExceptionId &id : std::as_const(_blackList)) {
+        if (!id.appName().isEmpty() && id.appName() != appName) {
+            continue;
+        }
+        if (id.className() == QStringLiteral("*") && !id.appName().isEmpty()) {
+            // application name matches and all classes are selected
+            _blackListAll = true;
+            continue;
+        }
+        _blackListClassNames.insert(id.className().toLatin1());
+    }
+}
+
+//_____________________________________________________________
+const WindowManager::ClassListState &WindowManager::classListState(const QWidget *widget)
+{
+    // the application name can be set after the style has been created
+    if (qApp->applicationName() != _listsAppName) {
+        compileLists();
+    }
+
+    const QMetaObject *metaObject(widget->metaObject());
+    auto iter(_classListStates.find(metaObject));
+    if (iter == _classListStates.end() || iter->className != metaObject->className()) {
+        // walk the class hierarchy, as QObject::inherits does
+        ClassListState state;
+        state.className = metaObject->className();
+        for (const QMetaObject *current = metaObject; current; current = current->superClass()) {
+            const QByteArray className(QByteArray::fromRawData(current->className(), qstrlen(current->className())));
+            state.whiteListed |= _whiteListClassNames.contains(className);
+            state.blackListed |= _blackListClassNames.contains(className);
+        }
+        iter = _classListStates.insert(metaObject, state);
+    }
+
+    return iter.value();
+}
+
 //_____________________________________________________________
 bool WindowManager::eventFilter(QObject *object, QEvent *event)
 {
@@ -294,7 +350,7 @@ bool WindowManager::mousePressEvent(QObject *object, QEvent *event)
     // If we are in a QQuickWidget we don't want to ever do dragging from a qwidget in the
     // hyerarchy, but only from an internal item, if any. If any event handler will manage
     // the event, we don't want the drag to start
-    if (object->inherits("QQuickWidget")) {
+    if (WidgetClassification::is(object, WidgetClassification::QuickWidget)) {
         _eventInQQuickWidget = true;
         event->setAccepted(false);
         return false;
@@ -427,18 +483,18 @@ bool WindowManager::isDragable(QWidget *widget)
     }
 
     // accepted default types
-    if ((qobject_cast<QDialog *>(widget) && widget->isWindow()) || (qobject_cast<QMainWindow *>(widget) && widget->isWindow())
-        || qobject_cast<QGroupBox *>(widget)) {
+    const WidgetClassification::Roles roles = WidgetClassification::roles(widget);
+    if (((roles & (WidgetClassification::Dialog | WidgetClassification::MainWindow)) && widget->isWindow()) || (roles & WidgetClassification::GroupBox)) {
         return true;
     }
 
     // more accepted types, provided they are not dock widget titles
-    if ((qobject_cast<QMenuBar *>(widget) || qobject_cast<QTabBar *>(widget) || qobject_cast<QStatusBar *>(widget) || qobject_cast<QToolBar *>(widget))
+    if ((roles & (WidgetClassification::MenuBar | WidgetClassification::TabBar | WidgetClassification::StatusBar | WidgetClassification::ToolBar))
         && !isDockWidgetTitle(widget)) {
         return true;
     }
 
-    if (widget->inherits("KScreenSaver") && widget->inherits("KCModule")) {
+    if ((roles & WidgetClassification::KScreenSaver) && (roles & WidgetClassification::KCModule)) {
         return true;
     }
 
@@ -447,8 +503,8 @@ bool WindowManager::isDragable(QWidget *widget)
     }
 
     // flat toolbuttons
-    if (auto toolButton = qobject_cast<QToolButton *>(widget)) {
-        if (toolButton->autoRaise()) {
+    if (roles & WidgetClassification::ToolButton) {
+        if (static_cast<QToolButton *>(widget)->autoRaise()) {
             return true;
         }
     }
@@ -460,14 +516,10 @@ bool WindowManager::isDragable(QWidget *widget)
     2/ it matches its parent viewport
     3/ the parent is not blacklisted
     */
-    if (auto listView = qobject_cast<QListView *>(widget->parentWidget())) {
-        if (listView->viewport() == widget && !isBlackListed(listView)) {
-            return true;
-        }
-    }
-
-    if (auto treeView = qobject_cast<QTreeView *>(widget->parentWidget())) {
-        if (treeView->viewport() == widget && !isBlackListed(treeView)) {
+    QWidget *parent(widget->parentWidget());
+    if (WidgetClassification::is(parent, WidgetClassification::ListView | WidgetClassification::TreeView)) {
+        auto itemView(static_cast<QAbstractItemView *>(parent));
+        if (itemView->viewport() == widget && !isBlackListed(itemView)) {
             return true;
         }
     }
@@ -477,14 +529,13 @@ bool WindowManager::isDragable(QWidget *widget)
     this is because of kstatusbar
     who captures buttonPress/release events
     */
-    if (auto label = qobject_cast<QLabel *>(widget)) {
-        if (label->textInteractionFlags().testFlag(Qt::TextSelectableByMouse)) {
+    if (roles & WidgetClassification::Label) {
+        if (static_cast<QLabel *>(widget)->textInteractionFlags().testFlag(Qt::TextSelectableByMouse)) {
             return false;
         }
 
-        QWidget *parent = label->parentWidget();
         while (parent) {
-            if (qobject_cast<QStatusBar *>(parent)) {
+            if (WidgetClassification::is(parent, WidgetClassification::StatusBar)) {
                 return true;
             }
             parent = parent->parentWidget();
@@ -504,39 +555,21 @@ bool WindowManager::isBlackListed(QWidget *widget)
     }
 
     // list-based blacklisted widgets
-    const auto appName(qApp->applicationName());
-    for (const ExceptionId &id : std::as_const(_blackList)) {
-        if (!id.appName().isEmpty() && id.appName() != appName) {
-            continue;
-        }
-        if (id.className() == QStringLiteral("*") && !id.appName().isEmpty()) {
-            // if application name matches and all classes are selected
-            // disable the grabbing entirely
-            setEnabled(false);
-            return true;
-        }
-        if (widget->inherits(id.className().toLatin1().data())) {
-            return true;
-        }
+    const ClassListState &state(classListState(widget));
+    if (_blackListAll) {
+        // if application name matches and all classes are selected
+        // disable the grabbing entirely
+        setEnabled(false);
+        return true;
     }
 
-    return false;
+    return state.blackListed;
 }
 
 //_____________________________________________________________
-bool WindowManager::isWhiteListed(QWidget *widget) const
+bool WindowManager::isWhiteListed(QWidget *widget)
 {
-    const auto appName(qApp->applicationName());
-    for (const ExceptionId &id : std::as_const(_whiteList)) {
-        if (!(id.appName().isEmpty() || id.appName() == appName)) {
-            continue;
-        }
-        if (widget->inherits(id.className().toLatin1().data())) {
-            return true;
-        }
-    }
-
-    return false;
+    return classListState(widget).whiteListed;
 }
 
 //_____________________________________________________________
@@ -580,20 +613,26 @@ bool WindowManager::canDrag(QWidget *widget, QWidget *child, const QPoint &posit
     check against children from which drag should never be enabled,
     even if mousePress/Move has been passed to the parent
     */
-    if (child && (qobject_cast<QComboBox *>(child) || qobject_cast<QProgressBar *>(child) || qobject_cast<QScrollBar *>(child))) {
+    if (WidgetClassification::is(child, WidgetClassification::ComboBox | WidgetClassification::ProgressBar | WidgetClassification::ScrollBar)) {
         return false;
     }
 
+    // only the checks below which depend on the position or the widget's state are made for each press
+    const WidgetClassification::Roles roles = WidgetClassification::roles(widget);
+
     // tool buttons
-    if (auto toolButton = qobject_cast<QToolButton *>(widget)) {
-        if (dragMode() == StyleConfigData::WD_MINIMAL && !qobject_cast<QToolBar *>(widget->parentWidget())) {
+    if (roles & WidgetClassification::ToolButton) {
+        if (dragMode() == StyleConfigData::WD_MINIMAL && !WidgetClassification::is(widget->parentWidget(), WidgetClassification::ToolBar)) {
             return false;
         }
+        auto toolButton(static_cast<QToolButton *>(widget));
         return toolButton->autoRaise() && !toolButton->isEnabled();
     }
 
     // check menubar
-    if (auto menuBar = qobject_cast<QMenuBar *>(widget)) {
+    if (roles & WidgetClassification::MenuBar) {
+        auto menuBar(static_cast<QMenuBar *>(widget));
+
         // do not drag from menubars embedded in Mdi windows
         if (findParent<QMdiSubWindow *>(widget)) {
             return false;
@@ -623,7 +662,7 @@ bool WindowManager::canDrag(QWidget *widget, QWidget *child, const QPoint &posit
     and does not come from a toolbar is rejected
     */
     if (dragMode() == StyleConfigData::WD_MINIMAL) {
-        if (qobject_cast<QToolBar *>(widget)) {
+        if (roles & WidgetClassification::ToolBar) {
             return true;
         } else {
             return false;
@@ -633,15 +672,17 @@ bool WindowManager::canDrag(QWidget *widget, QWidget *child, const QPoint &posit
     /* following checks are relevant only for WD_FULL mode */
 
     // tabbar. Make sure no tab is under the cursor
-    if (auto tabBar = qobject_cast<QTabBar *>(widget)) {
-        return tabBar->tabAt(position) == -1;
+    if (roles & WidgetClassification::TabBar) {
+        return static_cast<QTabBar *>(widget)->tabAt(position) == -1;
     }
 
     /*
     check groupboxes
     prevent drag if unchecking grouboxes
     */
-    if (auto groupBox = qobject_cast<QGroupBox *>(widget)) {
+    if (roles & WidgetClassification::GroupBox) {
+        auto groupBox(static_cast<QGroupBox *>(widget));
+
         // non checkable group boxes are always ok
         if (!groupBox->isCheckable()) {
             return true;
@@ -679,15 +720,17 @@ bool WindowManager::canDrag(QWidget *widget, QWidget *child, const QPoint &posit
     }
 
     // labels
-    if (auto label = qobject_cast<QLabel *>(widget)) {
-        if (label->textInteractionFlags().testFlag(Qt::TextSelectableByMouse)) {
+    if (roles & WidgetClassification::Label) {
+        if (static_cast<QLabel *>(widget)->textInteractionFlags().testFlag(Qt::TextSelectableByMouse)) {
             return false;
         }
     }
 
     // abstract item views
-    QAbstractItemView *itemView(nullptr);
-    if ((itemView = qobject_cast<QListView *>(widget->parentWidget())) || (itemView = qobject_cast<QTreeView *>(widget->parentWidget()))) {
+    QWidget *parent(widget->parentWidget());
+    const WidgetClassification::Roles parentRoles = WidgetClassification::roles(parent);
+    if (parentRoles & (WidgetClassification::ListView | WidgetClassification::TreeView)) {
+        auto itemView(static_cast<QAbstractItemView *>(parent));
         if (widget == itemView->viewport()) {
             // QListView
             if (itemView->frameShape() != QFrame::NoFrame) {
@@ -700,7 +743,8 @@ bool WindowManager::canDrag(QWidget *widget, QWidget *child, const QPoint &posit
             }
         }
 
-    } else if ((itemView = qobject_cast<QAbstractItemView *>(widget->parentWidget()))) {
+    } else if (parentRoles & WidgetClassification::AbstractItemView) {
+        auto itemView(static_cast<QAbstractItemView *>(parent));
         if (widget == itemView->viewport()) {
             // QAbstractItemView
             if (itemView->frameShape() != QFrame::NoFrame) {
@@ -710,7 +754,8 @@ bool WindowManager::canDrag(QWidget *widget, QWidget *child, const QPoint &posit
             }
         }
 
-    } else if (auto graphicsView = qobject_cast<QGraphicsView *>(widget->parentWidget())) {
+    } else if (parentRoles & WidgetClassification::GraphicsView) {
+        auto graphicsView(static_cast<QGraphicsView *>(parent));
         if (widget == graphicsView->viewport()) {
             // QGraphicsView
             if (graphicsView->frameShape() != QFrame::NoFrame) {
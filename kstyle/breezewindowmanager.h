@@ -14,6 +14,8 @@
 
 #include <QApplication>
 #include <QBasicTimer>
+#include <QByteArray>
+#include <QHash>
 #include <QObject>
 #include <QSet>
 #include <QString>
@@ -128,7 +130,7 @@ protected:
     bool isBlackListed(QWidget *);
 
     //* returns true if widget is dragable
-    bool isWhiteListed(QWidget *) const;
+    bool isWhiteListed(QWidget *);
 
     //* returns true if drag can be started from current widget
     bool canDrag(QWidget *);
@@ -225,6 +227,20 @@ private:
     //* exception set
     using ExceptionSet = QSet<ExceptionId>;
 
+    //* white and black list membership of a widget class
+    struct ClassListState {
+        //* name of the class the state was resolved for, as the meta object of an unloaded class can be reused by another class
+        QByteArray className;
+        bool whiteListed = false;
+        bool blackListed = false;
+    };
+
+    //* reduce the white and black lists to the class names which apply to the current application
+    void compileLists();
+
+    //* white and black list membership of the widget's class, resolved once per class
+    const ClassListState &classListState(const QWidget *);
+
     //* list of white listed special widgets
     /**
     it is read from options and is used to adjust
@@ -239,6 +255,26 @@ private:
     */
     ExceptionSet _blackList;
 
+    //*@name white and black lists compiled for the current application
+    //@{
+
+    //* application name the lists were compiled for
+    QString _listsAppName;
+
+    //* white listed class names
+    QSet<QByteArray> _whiteListClassNames;
+
+    //* black listed class names
+    QSet<QByteArray> _blackListClassNames;
+
+    //* true if dragging is black listed for all classes of the application
+    bool _blackListAll = false;
+
+    //* list membership per class
+    QHash<const QMetaObject *, ClassListState> _classListStates;
+
+    //@}
+
     //* drag point
     QPoint _dragPoint;
     QPoint _globalDragPoint;
@@ -12,10 +12,15 @@
 #include "breeze.h"
 #include "dbusmessages.h"
 #include "presetsmodel.h"
+#include "settingssnapshot.h"
+#include "statistics.h"
 #include "systemicongenerator.h"
 #include <QAbstractScrollArea>
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusReply>
 #include <QIcon>
 
 #include <KCMultiDialog>
@@ -90,6 +95,11 @@ CommandLineProcessResult processComandLine(QApplication &app, QCommandLineParser
                                      i18n("Generate klassy and klassy-dark system icons."));
     parser.addOption(generateIcons);
 
+    QCommandLineOption statsOption(QStringList() << "s"
+                                                 << "stats",
+                                   i18n("Print the cache, animation and reconfiguration statistics of the running Klassy window decoration as JSON."));
+    parser.addOption(statsOption);
+
     parser.process(app);
 
     char const *configFile = "klassy/klassyrc";
@@ -143,6 +153,7 @@ CommandLineProcessResult processComandLine(QApplication &app, QCommandLineParser
         InternalSettingsPtr internalSettings = InternalSettingsPtr(new InternalSettings());
         internalSettings->load();
         PresetsModel::loadPresetAndSave(internalSettings.data(), config.data(), presetsConfig.data(), parser.value(loadWindecoPresetOption), true);
+        SettingsSnapshot::write();
         DBusMessages::updateDecorationColorCache();
         DBusMessages::kwinReloadConfig();
 
@@ -160,6 +171,20 @@ CommandLineProcessResult processComandLine(QApplication &app, QCommandLineParser
         output << i18n("klassy and klassy-dark system icons generated.") << Qt::endl;
     }
 
+    if (parser.isSet(statsOption)) {
+        commandSet = true;
+        QDBusMessage message = QDBusMessage::createMethodCall(QString::fromLatin1(Statistics::dBusService),
+                                                              QString::fromLatin1(Statistics::dBusPath),
+                                                              QString::fromLatin1(Statistics::dBusInterface),
+                                                              QStringLiteral("statistics"));
+        QDBusReply<QString> reply = QDBusConnection::sessionBus().call(message);
+        if (!reply.isValid()) {
+            output << i18n("ERROR: Could not read the Klassy window decoration statistics: ") << reply.error().message() << Qt::endl;
+            return {CommandLineProcessResult::Status::Error};
+        }
+        output << reply.value() << Qt::endl;
+    }
+
     if (commandSet) {
         return {CommandLineProcessResult::Status::CommandsProcessedOk};
     } else {
@@ -9,15 +9,22 @@
 #include <KLocalizedString>
 #include <KSharedConfig>
 #include <QApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDir>
 #include <QDomDocument>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QPainter>
+#include <QRegularExpression>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QStringBuilder>
 #include <QSvgGenerator>
+#include <QThreadPool>
 #include <QVariantMap>
 
 namespace Breeze
@@ -70,12 +77,94 @@ void SystemIconGenerator::generateIconThemeDir(const QString themeDirPath,
                                                const QString inherits,
                                                const DecorationColors &decorationColors)
 {
-    QDir iconDir(themeDirPath);
-    if (iconDir.exists()) {
-        iconDir.removeRecursively();
+    const QString hashesPath = themeDirPath % QStringLiteral("/") % QLatin1String(s_inputHashesFileName);
+
+    // hashes of the inputs each icon was last generated from, keyed by path relative to the theme directory
+    QJsonObject previousHashes;
+    QFile previousHashesFile(hashesPath);
+    if (previousHashesFile.open(QIODevice::ReadOnly)) {
+        previousHashes = QJsonDocument::fromJson(previousHashesFile.readAll()).object();
+        previousHashesFile.close();
+    } else {
+        // generated by an earlier version without input hashes, so start afresh
+        QDir iconDir(themeDirPath);
+        if (iconDir.exists()) {
+            iconDir.removeRecursively();
+        }
+    }
+
+    const QByteArray settingsInputs = iconSettingsInputs();
+    const QString description = i18n("Auto-generated by Klassy window decoration");
+
+    QStringList directories;
+    QStringList scaledDirectories;
+    QJsonObject hashes;
+    QMutex hashesMutex;
+
+    QThreadPool threadPool;
+    for (int i = 0; i < m_scales.count(); i++) {
+        for (auto size = m_iconSizes.begin(); size != m_iconSizes.end(); size++) {
+            QString svgDirName = QString::number(size.value()) % QStringLiteral("-") % QString::number(i);
+            QString svgDirPath = themeDirPath % QStringLiteral("/") % svgDirName;
+            QDir dir(svgDirPath);
+            dir.mkpath(svgDirPath);
+
+            if (i == 0) {
+                directories.append(svgDirName);
+            } else {
+                scaledDirectories.append(svgDirName);
+            }
+
+            const qreal scale = m_scales.at(i);
+            for (auto &iconType : m_iconTypes) {
+                const QString relativePath = svgDirName % QStringLiteral("/") % iconType.name % QStringLiteral(".svg");
+                const QString filePath = themeDirPath % QStringLiteral("/") % relativePath;
+                const QString hash = QString::fromLatin1(iconInputsHash(settingsInputs, scale, size.value(), iconType, decorationColors).toHex());
+
+                // unchanged since last generated
+                if (previousHashes.value(relativePath).toString() == hash && QFile::exists(filePath)) {
+                    hashes.insert(relativePath, hash);
+                    continue;
+                }
+
+                // each icon is independent, so they are rendered in parallel
+                threadPool.start([=, this, &decorationColors, &hashes, &hashesMutex]() {
+                    if (generateIconFile(filePath, scale, size.value(), iconType, decorationColors, description)) {
+                        QMutexLocker locker(&hashesMutex);
+                        hashes.insert(relativePath, hash);
+                    }
+                });
+            }
+        }
+    }
+    threadPool.waitForDone();
+
+    // remove icons from scales or icon types no longer generated
+    for (auto previous = previousHashes.constBegin(); previous != previousHashes.constEnd(); previous++) {
+        if (!hashes.contains(previous.key())) {
+            QFile::remove(themeDirPath % QStringLiteral("/") % previous.key());
+        }
+    }
+    const QStringList svgDirs = QDir(themeDirPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &svgDir : svgDirs) {
+        if (!directories.contains(svgDir) && !scaledDirectories.contains(svgDir)) {
+            QDir(themeDirPath % QStringLiteral("/") % svgDir).removeRecursively();
+        }
+    }
+
+    QSaveFile hashesFile(hashesPath);
+    if (hashesFile.open(QIODevice::WriteOnly)) {
+        hashesFile.write(QJsonDocument(hashes).toJson(QJsonDocument::Compact));
+        hashesFile.commit();
+    }
+
+    // written last, and atomically by KConfig, so an icon loader never sees an index referring to icons which are not yet there
+    KConfig themeIndex(themeDirPath % QStringLiteral("/index.theme"), KConfig::SimpleConfig);
+    const QStringList previousGroups = themeIndex.groupList();
+    for (const QString &group : previousGroups) {
+        themeIndex.deleteGroup(group);
     }
 
-    KConfig themeIndex(themeDirPath % QStringLiteral("/index.theme"));
     KConfigGroup iconThemeGroup = themeIndex.group("Icon Theme");
     iconThemeGroup.writeEntry("Name", themeName);
     iconThemeGroup.writeEntry("Comment", themeName + i18n(" by Paul A McAuley, auto-generated by Klassy window decoration"));
@@ -98,28 +187,14 @@ void SystemIconGenerator::generateIconThemeDir(const QString themeDirPath,
     iconThemeGroup.writeEntry("DialogSizes", "16,22,32,48,64,128,256");
 
     iconThemeGroup.writeEntry("KDE-Extensions", ".svg");
+    iconThemeGroup.writeEntry("Directories", directories.join(QLatin1Char(',')));
+    if (!scaledDirectories.isEmpty()) {
+        iconThemeGroup.writeEntry("ScaledDirectories", scaledDirectories.join(QLatin1Char(',')));
+    }
 
     for (int i = 0; i < m_scales.count(); i++) {
         for (auto size = m_iconSizes.begin(); size != m_iconSizes.end(); size++) {
             QString svgDirName = QString::number(size.value()) % QStringLiteral("-") % QString::number(i);
-            QString svgDirPath = themeDirPath % QStringLiteral("/") % svgDirName;
-            QDir dir(svgDirPath);
-            dir.mkpath(svgDirPath);
-
-            if (i == 0) {
-                if (!iconThemeGroup.readEntry("Directories", "").isEmpty()) {
-                    iconThemeGroup.writeEntry("Directories", iconThemeGroup.readEntry("Directories") + "," + svgDirName);
-                } else {
-                    iconThemeGroup.writeEntry("Directories", svgDirName);
-                }
-            } else {
-                if (!iconThemeGroup.readEntry("ScaledDirectories", "").isEmpty()) {
-                    iconThemeGroup.writeEntry("ScaledDirectories", iconThemeGroup.readEntry("ScaledDirectories") + "," + svgDirName);
-                } else {
-                    iconThemeGroup.writeEntry("ScaledDirectories", svgDirName);
-                }
-            }
-
             KConfigGroup svgDirGroup = themeIndex.group(svgDirName);
             svgDirGroup.writeEntry("Size", QString::number(size.value()));
             if (i != 0) {
@@ -133,156 +208,201 @@ void SystemIconGenerator::generateIconThemeDir(const QString themeDirPath,
             } else {
                 svgDirGroup.writeEntry("Type", "Fixed");
             }
+        }
+    }
 
-            for (auto &iconType : m_iconTypes) {
-                QSvgGenerator svgGenerator;
-                QFile file(svgDirPath % QStringLiteral("/") % iconType.name % QStringLiteral(".svg"));
-                if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                    continue;
-                }
+    themeIndex.sync();
+}
 
-                svgGenerator.setOutputDevice(&file);
-                int scaledWidth = qRound(size.value() * m_scales.at(i));
-                QSize iconSizeScaled(scaledWidth, scaledWidth);
-                svgGenerator.setSize(iconSizeScaled);
-                svgGenerator.setViewBox(QRect(QPoint(0, 0), iconSizeScaled));
-                svgGenerator.setResolution(qRound(96 * m_scales.at(i)));
-                svgGenerator.setDescription(i18n("Auto-generated by Klassy window decoration"));
-                std::unique_ptr<QPainter> painter = std::make_unique<QPainter>();
-                painter->begin(&svgGenerator);
-
-                painter->setViewport(QRect(QPoint(0, 0), iconSizeScaled));
-                painter->setRenderHints(QPainter::RenderHint::Antialiasing);
-
-                QColor textColor = decorationColors.buttonPalette(iconType.type)->active()->foregroundNormal;
-                if (!textColor.isValid()) {
-                    textColor = decorationColors.buttonPalette(iconType.type)->active()->foregroundHover;
-                }
-                QString textColorString = textColor.name();
-                QPen pen((QColor(textColorString)));
-
-                bool boldButtons =
-                    (m_internalSettings->boldButtonIcons() == InternalSettings::EnumBoldButtonIcons::BoldIconsBold
-                     || (m_internalSettings->boldButtonIcons() == InternalSettings::EnumBoldButtonIcons::BoldIconsHiDpiOnly && m_scales.at(i) >= 1.2));
-
-                // paint the close background to SVG
-                if (iconType.type == DecorationButtonType::Close && iconType.name != QStringLiteral("window-close-symbolic")) {
-                    painter->setWindow(0, 0, 16, 16);
-                    painter->setPen(Qt::NoPen);
-                    painter->setBrush(decorationColors.buttonPalette(iconType.type)->active()->backgroundHover);
-
-                    if (m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeSmallCircle) {
-                        boldButtons ? painter->drawEllipse(QRectF(0, 0, 16, 16)) : painter->drawEllipse(QRectF(1, 1, 14, 14));
-                    } else {
-                        qreal cornerRadius = 0;
-                        if (m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeSmallRoundedSquare
-                            || m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeFullHeightRoundedRectangle
-                            || m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeIntegratedRoundedRectangle
-                            || m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeIntegratedRoundedRectangleGrouped) {
-                            if (m_internalSettings->buttonCornerRadius() == InternalSettings::EnumButtonCornerRadius::Custom) {
-                                cornerRadius = m_internalSettings->buttonCustomCornerRadius();
-                            } else {
-                                cornerRadius = m_internalSettings->cornerRadius();
-                            }
-                        }
+QByteArray SystemIconGenerator::iconSettingsInputs() const
+{
+    QByteArray inputs;
+    QDataStream stream(&inputs, QIODevice::WriteOnly);
+    stream << s_generatorVersion;
+
+    // colour settings only affect the icons through the generated colours, which are hashed per icon, so a colour change only regenerates the icons whose
+    // colours have changed
+    static const QRegularExpression colorSettingsKey(QStringLiteral("Colou?r|Opacity|Contrast|Accent"));
+    const KConfigSkeletonItem::List items = m_internalSettings->items();
+    for (const KConfigSkeletonItem *item : items) {
+        if (item->key().contains(colorSettingsKey)) {
+            continue;
+        }
+        stream << item->key() << item->property();
+    }
+    return inputs;
+}
 
-                        if ((cornerRadius < 0.2 && m_internalSettings->cornerRadius() < 2))
-                            painter->drawRect(QRectF(2, 2, 12, 12));
-                        else
-                            painter->drawRoundedRect(QRectF(2, 2, 12, 12), 20, 20, Qt::RelativeSize);
-                    }
-                    pen.setColor(textColor = decorationColors.buttonPalette(iconType.type)->active()->foregroundHover);
+QByteArray SystemIconGenerator::iconInputsHash(const QByteArray &settingsInputs,
+                                               const qreal scale,
+                                               const int size,
+                                               const iconType &iconType,
+                                               const DecorationColors &decorationColors)
+{
+    const DecorationButtonPaletteGroup *paletteGroup = decorationColors.buttonPalette(iconType.type)->active();
+
+    QByteArray inputs;
+    QDataStream stream(&inputs, QIODevice::WriteOnly);
+    stream << scale << size << static_cast<int>(iconType.type) << iconType.checked << iconType.name << paletteGroup->foregroundNormal
+           << paletteGroup->foregroundHover << paletteGroup->backgroundHover;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(settingsInputs);
+    hash.addData(inputs);
+    return hash.result();
+}
+
+bool SystemIconGenerator::generateIconFile(const QString &filePath,
+                                           const qreal scale,
+                                           const int size,
+                                           const iconType &iconType,
+                                           const DecorationColors &decorationColors,
+                                           const QString &description) const
+{
+    QSvgGenerator svgGenerator;
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    svgGenerator.setOutputDevice(&file);
+    int scaledWidth = qRound(size * scale);
+    QSize iconSizeScaled(scaledWidth, scaledWidth);
+    svgGenerator.setSize(iconSizeScaled);
+    svgGenerator.setViewBox(QRect(QPoint(0, 0), iconSizeScaled));
+    svgGenerator.setResolution(qRound(96 * scale));
+    svgGenerator.setDescription(description);
+    std::unique_ptr<QPainter> painter = std::make_unique<QPainter>();
+    painter->begin(&svgGenerator);
+
+    painter->setViewport(QRect(QPoint(0, 0), iconSizeScaled));
+    painter->setRenderHints(QPainter::RenderHint::Antialiasing);
+
+    QColor textColor = decorationColors.buttonPalette(iconType.type)->active()->foregroundNormal;
+    if (!textColor.isValid()) {
+        textColor = decorationColors.buttonPalette(iconType.type)->active()->foregroundHover;
+    }
+    QString textColorString = textColor.name();
+    QPen pen((QColor(textColorString)));
+
+    bool boldButtons =
+        (m_internalSettings->boldButtonIcons() == InternalSettings::EnumBoldButtonIcons::BoldIconsBold
+         || (m_internalSettings->boldButtonIcons() == InternalSettings::EnumBoldButtonIcons::BoldIconsHiDpiOnly && scale >= 1.2));
+
+    // paint the close background to SVG
+    if (iconType.type == DecorationButtonType::Close && iconType.name != QStringLiteral("window-close-symbolic")) {
+        painter->setWindow(0, 0, 16, 16);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(decorationColors.buttonPalette(iconType.type)->active()->backgroundHover);
+
+        if (m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeSmallCircle) {
+            boldButtons ? painter->drawEllipse(QRectF(0, 0, 16, 16)) : painter->drawEllipse(QRectF(1, 1, 14, 14));
+        } else {
+            qreal cornerRadius = 0;
+            if (m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeSmallRoundedSquare
+                || m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeFullHeightRoundedRectangle
+                || m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeIntegratedRoundedRectangle
+                || m_internalSettings->buttonShape() == InternalSettings::EnumButtonShape::ShapeIntegratedRoundedRectangleGrouped) {
+                if (m_internalSettings->buttonCornerRadius() == InternalSettings::EnumButtonCornerRadius::Custom) {
+                    cornerRadius = m_internalSettings->buttonCustomCornerRadius();
+                } else {
+                    cornerRadius = m_internalSettings->cornerRadius();
                 }
+            }
 
-                // paint the icon to SVG
-                auto [iconRenderer,
-                      localRenderingWidth](RenderDecorationButtonIcon::factory(m_internalSettings, painter.get(), false, boldButtons, m_scales.at(i)));
-                painter->setWindow(0, 0, localRenderingWidth, localRenderingWidth);
+            if ((cornerRadius < 0.2 && m_internalSettings->cornerRadius() < 2))
+                painter->drawRect(QRectF(2, 2, 12, 12));
+            else
+                painter->drawRoundedRect(QRectF(2, 2, 12, 12), 20, 20, Qt::RelativeSize);
+        }
+        pen.setColor(textColor = decorationColors.buttonPalette(iconType.type)->active()->foregroundHover);
+    }
 
-                pen.setWidthF(PenWidth::Symbol * qMax((qreal)1.0, qreal(localRenderingWidth) / iconSizeScaled.width()));
-                painter->setPen(pen);
-                iconRenderer->setForceEvenSquares(true);
-                iconRenderer->setStrokeToFilledPath(true);
+    // paint the icon to SVG
+    auto [iconRenderer,
+          localRenderingWidth](RenderDecorationButtonIcon::factory(m_internalSettings, painter.get(), false, boldButtons, scale));
+    painter->setWindow(0, 0, localRenderingWidth, localRenderingWidth);
 
-                iconRenderer->renderIcon(iconType.type, iconType.checked);
+    pen.setWidthF(PenWidth::Symbol * qMax((qreal)1.0, qreal(localRenderingWidth) / iconSizeScaled.width()));
+    painter->setPen(pen);
+    iconRenderer->setForceEvenSquares(true);
+    iconRenderer->setStrokeToFilledPath(true);
 
-                painter->end();
-                file.close();
+    iconRenderer->renderIcon(iconType.type, iconType.checked);
 
-                // modify SVG XML attributes so KIconLoader can replace the colours with those from the current colour scheme
-                if (!file.open(QIODevice::ReadWrite | QIODevice::Text)) {
-                    continue;
-                }
+    painter->end();
+    file.close();
 
-                QDomDocument svgXml;
-                if (!svgXml.setContent(&file)) {
-                    file.close();
-                    continue;
-                } else {
-                    file.close();
-                    file.remove();
-                }
+    // modify SVG XML attributes so KIconLoader can replace the colours with those from the current colour scheme
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Text)) {
+        return false;
+    }
 
-                QDomNodeList svgElements = svgXml.elementsByTagName(QStringLiteral("svg"));
-                if (!svgElements.count()) {
-                    file.close();
-                    continue;
-                }
+    QDomDocument svgXml;
+    if (!svgXml.setContent(&file)) {
+        file.close();
+        return false;
+    } else {
+        file.close();
+        file.remove();
+    }
+
+    QDomNodeList svgElements = svgXml.elementsByTagName(QStringLiteral("svg"));
+    if (!svgElements.count()) {
+        file.close();
+        return false;
+    }
 
-                QDomNode svgElement = svgElements.at(0);
-                // add system colours CSS
-                QDomElement styleElement = svgXml.createElement(QStringLiteral("style"));
-                styleElement.setAttribute(QStringLiteral("id"), QStringLiteral("current-color-scheme"));
-                styleElement.setAttribute(QStringLiteral("type"), QStringLiteral("text/css"));
-                QDomText styleText = svgXml.createTextNode(QStringLiteral(".ColorScheme-Text {color:") % textColorString % QStringLiteral(";}"));
-                QDomElement svgFirstChild = svgElement.firstChildElement();
-                svgElement.insertBefore(styleElement, svgFirstChild);
-                styleElement.appendChild(styleText);
-
-                QDomNodeList svgChildNodes = svgElement.childNodes();
-                for (int j = 0; j < svgChildNodes.count(); j++) {
-                    QDomElement svgChildElement = svgChildNodes.at(j).toElement();
-                    if (!svgChildElement.isNull() && svgChildElement.tagName() == QStringLiteral("g")) {
-                        QDomNodeList svgGroups = svgChildElement.childNodes();
-                        for (int k = svgGroups.count() - 1; k >= 0; k--) { // looping backwards as we remove nodes
-                            QDomElement svgGroupElement = svgGroups.at(k).toElement();
-                            if (!svgGroupElement.isNull() && svgGroupElement.tagName() == QStringLiteral("g")) {
-                                if (!svgGroupElement.hasChildNodes()) { // remove empty groups
-                                    svgChildElement.removeChild(svgGroupElement);
-                                } else if (svgGroupElement.attribute(QStringLiteral("fill")) == QStringLiteral("none")
-                                           && svgGroupElement.attribute(QStringLiteral("stroke"))
-                                               == QStringLiteral("none")) { // remove invisible groups - fixes rendering in GTK apps
-                                    svgChildElement.removeChild(svgGroupElement);
-                                } else { // change attributes so KIconLoader can use system colours
-                                    // don't overwrite white close button foregrounds
-                                    if (!(iconType.type == DecorationButtonType::Close && iconType.name != QStringLiteral("window-close-symbolic")
-                                          && textColorString == QStringLiteral("#ffffff"))) {
-                                        svgGroupElement.setAttribute(QStringLiteral("class"), QStringLiteral("ColorScheme-Text"));
-                                        if (svgGroupElement.attribute(QStringLiteral("stroke")) == textColorString) {
-                                            svgGroupElement.setAttribute(QStringLiteral("stroke"), QStringLiteral("currentColor"));
-                                        }
-                                        if (svgGroupElement.attribute(QStringLiteral("fill")) == textColorString) {
-                                            svgGroupElement.setAttribute(QStringLiteral("fill"), QStringLiteral("currentColor"));
-                                        }
-                                    }
-                                }
+    QDomNode svgElement = svgElements.at(0);
+    // add system colours CSS
+    QDomElement styleElement = svgXml.createElement(QStringLiteral("style"));
+    styleElement.setAttribute(QStringLiteral("id"), QStringLiteral("current-color-scheme"));
+    styleElement.setAttribute(QStringLiteral("type"), QStringLiteral("text/css"));
+    QDomText styleText = svgXml.createTextNode(QStringLiteral(".ColorScheme-Text {color:") % textColorString % QStringLiteral(";}"));
+    QDomElement svgFirstChild = svgElement.firstChildElement();
+    svgElement.insertBefore(styleElement, svgFirstChild);
+    styleElement.appendChild(styleText);
+
+    QDomNodeList svgChildNodes = svgElement.childNodes();
+    for (int j = 0; j < svgChildNodes.count(); j++) {
+        QDomElement svgChildElement = svgChildNodes.at(j).toElement();
+        if (!svgChildElement.isNull() && svgChildElement.tagName() == QStringLiteral("g")) {
+            QDomNodeList svgGroups = svgChildElement.childNodes();
+            for (int k = svgGroups.count() - 1; k >= 0; k--) { // looping backwards as we remove nodes
+                QDomElement svgGroupElement = svgGroups.at(k).toElement();
+                if (!svgGroupElement.isNull() && svgGroupElement.tagName() == QStringLiteral("g")) {
+                    if (!svgGroupElement.hasChildNodes()) { // remove empty groups
+                        svgChildElement.removeChild(svgGroupElement);
+                    } else if (svgGroupElement.attribute(QStringLiteral("fill")) == QStringLiteral("none")
+                               && svgGroupElement.attribute(QStringLiteral("stroke"))
+                                   == QStringLiteral("none")) { // remove invisible groups - fixes rendering in GTK apps
+                        svgChildElement.removeChild(svgGroupElement);
+                    } else { // change attributes so KIconLoader can use system colours
+                        // don't overwrite white close button foregrounds
+                        if (!(iconType.type == DecorationButtonType::Close && iconType.name != QStringLiteral("window-close-symbolic")
+                              && textColorString == QStringLiteral("#ffffff"))) {
+                            svgGroupElement.setAttribute(QStringLiteral("class"), QStringLiteral("ColorScheme-Text"));
+                            if (svgGroupElement.attribute(QStringLiteral("stroke")) == textColorString) {
+                                svgGroupElement.setAttribute(QStringLiteral("stroke"), QStringLiteral("currentColor"));
+                            }
+                            if (svgGroupElement.attribute(QStringLiteral("fill")) == textColorString) {
+                                svgGroupElement.setAttribute(QStringLiteral("fill"), QStringLiteral("currentColor"));
                             }
                         }
                     }
                 }
-
-                if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-                    continue;
-                }
-                QTextStream output(&file);
-                svgXml.save(output, 4);
-
-                file.close();
             }
         }
     }
 
-    themeIndex.sync();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream output(&file);
+    svgXml.save(output, 4);
+
+    file.close();
+    return true;
 }
 
 void SystemIconGenerator::addSystemScales()
@@ -23,6 +23,32 @@ private:
     void addSystemScales();
     void generateIconThemeDir(const QString themeDirPath, const QString themeName, const QString inherits, const DecorationColors &decorationColors);
 
+    struct iconType;
+
+    //* writes a single SVG icon, returning false on failure; only reads shared state, so may be called from worker threads
+    bool generateIconFile(const QString &filePath,
+                          const qreal scale,
+                          const int size,
+                          const iconType &iconType,
+                          const DecorationColors &decorationColors,
+                          const QString &description) const;
+
+    //* serialised settings affecting every icon's appearance, excluding colour settings
+    QByteArray iconSettingsInputs() const;
+
+    //* hash of everything an individual icon file is generated from, used to skip regenerating unchanged icons
+    static QByteArray iconInputsHash(const QByteArray &settingsInputs,
+                                     const qreal scale,
+                                     const int size,
+                                     const iconType &iconType,
+                                     const DecorationColors &decorationColors);
+
+    //* bump whenever the icon rendering changes, to invalidate previously generated icons
+    static constexpr int s_generatorVersion = 1;
+
+    //* file in each theme directory recording the input hash of each generated icon
+    static constexpr const char *s_inputHashesFileName = ".klassy-icon-hashes.json";
+
     InternalSettingsPtr m_internalSettings;
 
     QList<qreal> m_scales = {1, 1.25, 1.5, 1.75, 2, 2.25, 2.5, 2.75, 3};
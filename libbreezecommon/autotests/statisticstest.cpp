@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "statistics.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+using namespace Breeze;
+
+class StatisticsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void testStatisticsOverDBus();
+    void testResetStatisticsOverDBus();
+
+private:
+    //* call a method of the Statistics interface exported by this process, returns the reply
+    QDBusMessage callStatistics(const QString &method) const;
+
+    //* call statistics() over D-Bus and parse the reply
+    QJsonObject readStatistics() const;
+};
+
+//________________________________________________________________
+void StatisticsTest::initTestCase()
+{
+    // the test is run under dbus-run-session, so this is a private bus
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+    QVERIFY(Statistics::self()->registerOnSessionBus());
+}
+
+//________________________________________________________________
+void StatisticsTest::init()
+{
+    Statistics::self()->resetStatistics();
+}
+
+//________________________________________________________________
+QDBusMessage StatisticsTest::callStatistics(const QString &method) const
+{
+    // address this process by its unique bus name, as KWin owns org.kde.KWin in a real session
+    QDBusMessage message = QDBusMessage::createMethodCall(QDBusConnection::sessionBus().baseService(),
+                                                          QString::fromLatin1(Statistics::dBusPath),
+                                                          QString::fromLatin1(Statistics::dBusInterface),
+                                                          method);
+    return QDBusConnection::sessionBus().call(message);
+}
+
+//________________________________________________________________
+QJsonObject StatisticsTest::readStatistics() const
+{
+    const QDBusMessage reply = callStatistics(QStringLiteral("statistics"));
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().size() != 1) {
+        return QJsonObject();
+    }
+
+    return QJsonDocument::fromJson(reply.arguments().constFirst().toString().toUtf8()).object();
+}
+
+//________________________________________________________________
+void StatisticsTest::testStatisticsOverDBus()
+{
+    Statistics *statistics = Statistics::self();
+    statistics->recordCacheHit("testCache");
+    statistics->recordCacheHit("testCache");
+    statistics->recordCacheHit("testCache");
+    statistics->recordCacheMiss("testCache");
+    statistics->setCacheBytes("testCache", 4096);
+    statistics->increment("testCounter");
+    statistics->increment("testCounter", 4);
+    statistics->setGauge("testGauge", 7);
+    statistics->recordDuration("testDuration", 2000000);
+    statistics->recordDuration("testDuration", 4000000);
+
+    const QJsonObject json = readStatistics();
+    QVERIFY(!json.isEmpty());
+
+    const QJsonObject cache = json.value(QStringLiteral("caches")).toObject().value(QStringLiteral("testCache")).toObject();
+    QCOMPARE(cache.value(QStringLiteral("hits")).toInt(), 3);
+    QCOMPARE(cache.value(QStringLiteral("misses")).toInt(), 1);
+    QCOMPARE(cache.value(QStringLiteral("hitRatio")).toDouble(), 0.75);
+    QCOMPARE(cache.value(QStringLiteral("bytes")).toInt(), 4096);
+
+    QCOMPARE(json.value(QStringLiteral("counters")).toObject().value(QStringLiteral("testCounter")).toInt(), 5);
+    QCOMPARE(json.value(QStringLiteral("gauges")).toObject().value(QStringLiteral("testGauge")).toInt(), 7);
+
+    const QJsonObject duration = json.value(QStringLiteral("durations")).toObject().value(QStringLiteral("testDuration")).toObject();
+    QCOMPARE(duration.value(QStringLiteral("count")).toInt(), 2);
+    QCOMPARE(duration.value(QStringLiteral("totalMs")).toDouble(), 6.0);
+    QCOMPARE(duration.value(QStringLiteral("meanMs")).toDouble(), 3.0);
+    QCOMPARE(duration.value(QStringLiteral("maxMs")).toDouble(), 4.0);
+}
+
+//________________________________________________________________
+void StatisticsTest::testResetStatisticsOverDBus()
+{
+    Statistics::self()->increment("testCounter");
+    QVERIFY(readStatistics().value(QStringLiteral("counters")).toObject().contains(QStringLiteral("testCounter")));
+
+    QCOMPARE(callStatistics(QStringLiteral("resetStatistics")).type(), QDBusMessage::ReplyMessage);
+    QVERIFY(!readStatistics().value(QStringLiteral("counters")).toObject().contains(QStringLiteral("testCounter")));
+}
+
+QTEST_GUILESS_MAIN(StatisticsTest)
+
+#include "statisticstest.moc"
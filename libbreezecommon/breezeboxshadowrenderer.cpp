@@ -17,6 +17,7 @@
 
 // own
 #include "breezeboxshadowrenderer.h"
+#include "tracing.h"
 
 // Qt
 #include <QPainter>
@@ -305,6 +306,7 @@ void BoxShadowRenderer::addShadow(const QPoint &offset, int radius, const QColor
 
 QImage BoxShadowRenderer::render() const
 {
+    KLASSY_TRACE_SCOPE("common", "BoxShadowRenderer::render");
     if (m_shadows.isEmpty()) {
         return {};
     }
@@ -7,13 +7,37 @@
 #include <KIconLoader>
 #include <QDBusConnection>
 #include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QThreadPool>
+
+#include <utility>
 
 namespace Breeze
 {
 
-DBusUpdateNotifier g_dBusUpdateNotifier;
+DBusUpdateNotifier *DBusUpdateNotifier::s_self = nullptr;
+
+DBusUpdateNotifier *DBusUpdateNotifier::self()
+{
+    // deliberately never deleted, as with the other process-wide singletons shared by the decoration and style
+    if (!s_self) {
+        s_self = new DBusUpdateNotifier();
+    }
+
+    return s_self;
+}
 
 DBusUpdateNotifier::DBusUpdateNotifier()
+{
+    // connecting to the session bus and registering the matches block until the bus replies, so are done on a worker thread rather than the GUI thread
+    // the signals are still delivered to this object's thread
+    QThreadPool::globalInstance()->start([this]() {
+        subscribe();
+    });
+}
+
+void DBusUpdateNotifier::subscribe()
 {
     QDBusConnection dBusConnection = QDBusConnection::sessionBus();
 
@@ -33,6 +57,25 @@ DBusUpdateNotifier::DBusUpdateNotifier()
                            SLOT(onWindowDecorationSettingsUpdate()));
 }
 
+void DBusUpdateNotifier::subscribeGlobalSettings()
+{
+    if (m_globalSettingsSubscribed) {
+        return;
+    }
+    m_globalSettingsSubscribed = true;
+
+    m_globalSettingsDebounceTimer.setSingleShot(true);
+    m_globalSettingsDebounceTimer.setInterval(s_globalSettingsDebounceInterval);
+    connect(&m_globalSettingsDebounceTimer, &QTimer::timeout, this, &DBusUpdateNotifier::flushGlobalSettingsChanges);
+
+    QDBusConnection::sessionBus().connect(QString(),
+                                          QStringLiteral("/KGlobalSettings"),
+                                          QStringLiteral("org.kde.KGlobalSettings"),
+                                          QStringLiteral("notifyChange"),
+                                          this,
+                                          SLOT(onGlobalSettingsChange(int, int)));
+}
+
 void DBusUpdateNotifier::onWindowDecorationSettingsUpdate()
 {
     Q_EMIT decorationSettingsUpdate(QUuid::createUuid().toByteArray());
@@ -49,4 +92,91 @@ void DBusUpdateNotifier::onSystemSettingUpdate(QString first, QString second, QD
     }
 }
 
+void DBusUpdateNotifier::onGlobalSettingsChange(int changeType, int arg)
+{
+    switch (static_cast<GlobalSettingsChangeType>(changeType)) {
+    case GlobalSettingsChangeType::PaletteChanged:
+        m_pendingGlobalPaletteChange = true;
+        break;
+    case GlobalSettingsChangeType::FontChanged:
+        m_pendingGlobalFontsChange = true;
+        break;
+    case GlobalSettingsChangeType::StyleChanged:
+    case GlobalSettingsChangeType::IconChanged:
+        m_pendingGlobalSettingsChange = true;
+        break;
+    case GlobalSettingsChangeType::SettingsChanged:
+        // animation speed and look-and-feel options are sent as style settings; mouse, paths, shortcuts etc. do not affect the decoration
+        if (static_cast<GlobalSettingsCategory>(arg) == GlobalSettingsCategory::Style || static_cast<GlobalSettingsCategory>(arg) == GlobalSettingsCategory::Qt) {
+            m_pendingGlobalSettingsChange = true;
+            break;
+        }
+        return;
+    default: // cursor, toolbar style, clipboard, shortcuts and sorting changes are irrelevant
+        return;
+    }
+
+    m_globalSettingsDebounceTimer.start();
+}
+
+bool DBusUpdateNotifier::tabletMode()
+{
+    if (m_tabletModeSubscribed) {
+        return m_tabletMode;
+    }
+    m_tabletModeSubscribed = true;
+
+    QDBusConnection dBusConnection = QDBusConnection::sessionBus();
+    dBusConnection.connect(QStringLiteral("org.kde.KWin"),
+                           QStringLiteral("/org/kde/KWin"),
+                           QStringLiteral("org.kde.KWin.TabletModeManager"),
+                           QStringLiteral("tabletModeChanged"),
+                           QStringLiteral("b"),
+                           this,
+                           SLOT(onTabletModeChanged(bool)));
+
+    auto message = QDBusMessage::createMethodCall(QStringLiteral("org.kde.KWin"),
+                                                  QStringLiteral("/org/kde/KWin"),
+                                                  QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                  QStringLiteral("Get"));
+    message.setArguments({QStringLiteral("org.kde.KWin.TabletModeManager"), QStringLiteral("tabletMode")});
+    auto call = new QDBusPendingCallWatcher(dBusConnection.asyncCall(message), this);
+    connect(call, &QDBusPendingCallWatcher::finished, this, [this, call]() {
+        QDBusPendingReply<QVariant> reply = *call;
+        if (!reply.isError()) {
+            onTabletModeChanged(reply.value().toBool());
+        }
+
+        call->deleteLater();
+    });
+
+    return m_tabletMode;
+}
+
+void DBusUpdateNotifier::onTabletModeChanged(bool mode)
+{
+    if (mode == m_tabletMode) {
+        return;
+    }
+    m_tabletMode = mode;
+    Q_EMIT tabletModeChanged(mode);
+}
+
+void DBusUpdateNotifier::flushGlobalSettingsChanges()
+{
+    const bool paletteChange = std::exchange(m_pendingGlobalPaletteChange, false);
+    const bool fontsChange = std::exchange(m_pendingGlobalFontsChange, false);
+    const bool settingsChange = std::exchange(m_pendingGlobalSettingsChange, false);
+
+    if (paletteChange) {
+        Q_EMIT globalPaletteUpdate(QUuid::createUuid().toByteArray());
+    }
+
+    if (settingsChange) {
+        Q_EMIT globalSettingsUpdate();
+    } else if (fontsChange) {
+        Q_EMIT globalFontsUpdate();
+    }
+}
+
 }
@@ -10,6 +10,7 @@
 #include "breezecommon_export.h"
 #include <QDBusVariant>
 #include <QString>
+#include <QTimer>
 
 namespace Breeze
 {
@@ -19,18 +20,96 @@ class BREEZECOMMON_EXPORT DBusUpdateNotifier : public QObject
     Q_OBJECT
 
 public:
-    DBusUpdateNotifier();
+    //* singleton, constructed on first use rather than when the library is loaded
+    static DBusUpdateNotifier *self();
+
+    //* org.kde.KGlobalSettings notifyChange change types, matching KGlobalSettings::ChangeType
+    enum class GlobalSettingsChangeType {
+        PaletteChanged = 0,
+        FontChanged,
+        StyleChanged,
+        SettingsChanged,
+        IconChanged,
+        CursorChanged,
+        ToolbarStyleChanged,
+        ClipboardConfigChanged,
+        BlockShortcuts,
+        NaturalSortingChanged,
+    };
+
+    //* org.kde.KGlobalSettings notifyChange argument for SettingsChanged, matching KGlobalSettings::SettingsCategory
+    enum class GlobalSettingsCategory {
+        Mouse = 0,
+        Completion,
+        Paths,
+        PopupMenu,
+        Qt,
+        Shortcuts,
+        Locale,
+        Style,
+    };
+
+    /**
+     * @brief Subscribe to org.kde.KGlobalSettings notifyChange, so that the debounced global settings signals below are emitted.
+     *        Only the decoration acts on them, so processes which only load the style never subscribe; later calls do nothing.
+     */
+    void subscribeGlobalSettings();
+
+    /**
+     * @brief Whether KWin is in tablet mode, as last known.
+     *        The first call subscribes to KWin's TabletModeManager and queries the initial state asynchronously, so that the process has a single
+     *        subscription and query however many decorations use it; tabletModeChanged is emitted if the queried state differs.
+     */
+    bool tabletMode();
 
 public Q_SLOTS:
     void onWindowDecorationSettingsUpdate();
     void onSystemSettingUpdate(QString, QString, QDBusVariant);
+    void onGlobalSettingsChange(int changeType, int arg);
+    void onTabletModeChanged(bool mode);
 
 Q_SIGNALS:
     void decorationSettingsUpdate(QByteArray uuid);
     void systemColorSchemeUpdate(QByteArray uuid);
     void systemIconsUpdate();
-};
 
-extern DBusUpdateNotifier BREEZECOMMON_EXPORT g_dBusUpdateNotifier;
+    //*@name debounced KGlobalSettings changes; only the minimal update is emitted, and globalSettingsUpdate supersedes globalFontsUpdate
+    //@{
+    void globalPaletteUpdate(QByteArray uuid);
+    void globalFontsUpdate();
+    void globalSettingsUpdate();
+    //@}
+
+    //* emitted only when the tablet mode changes, once tabletMode() has been called
+    void tabletModeChanged(bool mode);
+
+private Q_SLOTS:
+    void flushGlobalSettingsChanges();
+
+private:
+    //* constructor
+    DBusUpdateNotifier();
+
+    //* subscribe to the D-Bus signals; run on a worker thread so as not to block the GUI thread of applications using the style
+    void subscribe();
+
+    //* time to wait for further KGlobalSettings changes before dispatching, as e.g. applying a global theme sends a burst of them
+    static constexpr int s_globalSettingsDebounceInterval = 50;
+
+    QTimer m_globalSettingsDebounceTimer;
+    bool m_pendingGlobalPaletteChange = false;
+    bool m_pendingGlobalFontsChange = false;
+    bool m_pendingGlobalSettingsChange = false;
+
+    //* only processes with a decoration subscribe to KGlobalSettings changes
+    bool m_globalSettingsSubscribed = false;
+
+    //* only processes with a decoration subscribe to tablet mode changes
+    bool m_tabletModeSubscribed = false;
+    bool m_tabletMode = false;
+
+    //* singleton
+    static DBusUpdateNotifier *s_self;
+};
 
 }
@@ -5,10 +5,14 @@
  */
 #include "decorationbuttoncolors.h"
 #include "colortools.h"
+#include "tracing.h"
 #include <KColorUtils>
+#include <QDataStream>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMutex>
 
 namespace Breeze
 {
@@ -21,26 +25,127 @@ DecorationButtonPalette::DecorationButtonPalette(DecorationButtonType buttonType
 {
 }
 
-void DecorationButtonPalette::generate(InternalSettingsPtr decorationSettings,
-                                       DecorationColors *decorationColors,
-                                       const bool generateOneGroupOnly,
-                                       const bool oneGroupActiveState)
+int DecorationButtonPalette::generate(InternalSettingsPtr decorationSettings,
+                                      DecorationColors *decorationColors,
+                                      const bool generateOneGroupOnly,
+                                      const bool oneGroupActiveState)
 {
+    KLASSY_TRACE_SCOPE("common", "DecorationButtonPalette::generate");
     _decorationSettings = decorationSettings;
     _decorationColors = decorationColors;
 
+    int regeneratedGroups = 0;
+
     if (!(generateOneGroupOnly && !oneGroupActiveState)) { // active
-        decodeButtonOverrideColors(true);
-        generateButtonBackgroundPalette(true);
-        generateButtonForegroundPalette(true);
-        generateButtonOutlinePalette(true);
+        QByteArray generationInputs = this->generationInputs(true);
+        if (generationInputs != _generationInputsActive) {
+            decodeButtonOverrideColors(true);
+            generateButtonBackgroundPalette(true);
+            generateButtonForegroundPalette(true);
+            generateButtonOutlinePalette(true);
+            _generationInputsActive = generationInputs;
+            regeneratedGroups++;
+        }
     }
 
     if (!(generateOneGroupOnly && oneGroupActiveState)) { // inactive
-        decodeButtonOverrideColors(false);
-        generateButtonBackgroundPalette(false);
-        generateButtonForegroundPalette(false);
-        generateButtonOutlinePalette(false);
+        QByteArray generationInputs = this->generationInputs(false);
+        if (generationInputs != _generationInputsInactive) {
+            decodeButtonOverrideColors(false);
+            generateButtonBackgroundPalette(false);
+            generateButtonForegroundPalette(false);
+            generateButtonOutlinePalette(false);
+            _generationInputsInactive = generationInputs;
+            regeneratedGroups++;
+        }
+    }
+
+    if (regeneratedGroups) {
+        generateTransitions();
+    }
+
+    return regeneratedGroups;
+}
+
+QByteArray DecorationButtonPalette::generationInputs(const bool active) const
+{
+    QByteArray inputs;
+    QDataStream stream(&inputs, QIODevice::WriteOnly);
+
+    // override colours can refer to either decoration palette group, so both are always inputs
+    for (const DecorationPaletteGroup *group : {_decorationColors->active(), _decorationColors->inactive()}) {
+        stream << group->titleBarBase << group->titleBarText << group->windowOutline << group->shadow << group->buttonFocus << group->buttonHover
+               << group->highlight << group->highlightLessSaturated << group->negative << group->negativeLessSaturated << group->negativeSaturated
+               << group->fullySaturatedNegative << group->neutral << group->neutralLessSaturated << group->neutralSaturated << group->positive
+               << group->positiveLessSaturated << group->positiveSaturated;
+    }
+
+    stream << (active ? _decorationSettings->buttonOverrideColorsActive(static_cast<int>(_buttonType))
+                      : _decorationSettings->buttonOverrideColorsInactive(static_cast<int>(_buttonType)));
+
+    stream << _decorationSettings->adjustBackgroundColorOnPoorContrast(active) << _decorationSettings->buttonBackgroundColors(active)
+           << _decorationSettings->buttonBackgroundOpacity(active) << _decorationSettings->buttonIconColors(active)
+           << _decorationSettings->buttonIconOpacity(active) << _decorationSettings->closeButtonIconColor(active)
+           << _decorationSettings->negativeCloseBackgroundHoverPress(active) << _decorationSettings->onPoorIconContrast(active)
+           << _decorationSettings->poorBackgroundContrastThreshold(active) << _decorationSettings->poorIconContrastThreshold(active)
+           << _decorationSettings->useHoverAccent(active);
+
+    stream << _decorationSettings->showBackgroundNormally(active) << _decorationSettings->showBackgroundOnHover(active)
+           << _decorationSettings->showBackgroundOnPress(active) << _decorationSettings->showCloseBackgroundNormally(active)
+           << _decorationSettings->showCloseBackgroundOnHover(active) << _decorationSettings->showCloseBackgroundOnPress(active)
+           << _decorationSettings->showIconNormally(active) << _decorationSettings->showIconOnHover(active) << _decorationSettings->showIconOnPress(active)
+           << _decorationSettings->showCloseIconNormally(active) << _decorationSettings->showCloseIconOnHover(active)
+           << _decorationSettings->showCloseIconOnPress(active) << _decorationSettings->showOutlineNormally(active)
+           << _decorationSettings->showOutlineOnHover(active) << _decorationSettings->showOutlineOnPress(active)
+           << _decorationSettings->showCloseOutlineNormally(active) << _decorationSettings->showCloseOutlineOnHover(active)
+           << _decorationSettings->showCloseOutlineOnPress(active);
+
+    stream << _decorationSettings->varyColorBackground(active) << _decorationSettings->varyColorCloseBackground(active)
+           << _decorationSettings->varyColorIcon(active) << _decorationSettings->varyColorCloseIcon(active)
+           << _decorationSettings->varyColorOutline(active) << _decorationSettings->varyColorCloseOutline(active);
+
+    return inputs;
+}
+
+void ColorTransition::generate(const QColor &from, const QColor &to, const bool fadeOutFromWhenToInvalid)
+{
+    m_valid = to.isValid() || (from.isValid() && fadeOutFromWhenToInvalid);
+    if (!m_valid) {
+        return;
+    }
+
+    for (int i = 0; i <= Steps; i++) {
+        const qreal progress = qreal(i) / Steps;
+        QColor color;
+        if (from.isValid() && to.isValid()) {
+            color = KColorUtils::mix(from, to, progress);
+        } else if (to.isValid()) {
+            color = ColorTools::alphaMix(to, progress);
+        } else {
+            color = ColorTools::alphaMix(from, 1.0 - progress);
+        }
+        m_colors[i] = color.rgba();
+    }
+}
+
+void DecorationButtonPalette::generateTransitions()
+{
+    // the active state change animation fades in/out a colour which is only valid in one of the two states
+    _activeStateTransitions.foregroundPress.generate(_inactive->foregroundPress, _active->foregroundPress);
+    _activeStateTransitions.foregroundHover.generate(_inactive->foregroundHover, _active->foregroundHover);
+    _activeStateTransitions.foregroundNormal.generate(_inactive->foregroundNormal, _active->foregroundNormal);
+    _activeStateTransitions.backgroundPress.generate(_inactive->backgroundPress, _active->backgroundPress);
+    _activeStateTransitions.backgroundHover.generate(_inactive->backgroundHover, _active->backgroundHover);
+    _activeStateTransitions.backgroundNormal.generate(_inactive->backgroundNormal, _active->backgroundNormal);
+    _activeStateTransitions.outlinePress.generate(_inactive->outlinePress, _active->outlinePress);
+    _activeStateTransitions.outlineHover.generate(_inactive->outlineHover, _active->outlineHover);
+    _activeStateTransitions.outlineNormal.generate(_inactive->outlineNormal, _active->outlineNormal);
+
+    // the hover animation draws nothing if there is no hover colour
+    for (DecorationButtonPaletteGroup *group : {_active.get(), _inactive.get()}) {
+        group->foregroundHoverTransition.generate(group->foregroundNormal, group->foregroundHover, false);
+        group->backgroundHoverTransition.generate(group->backgroundNormal, group->backgroundHover, false);
+        group->outlineHoverTransition.generate(group->outlineNormal, group->outlineHover, false);
     }
 }
 
@@ -52,116 +157,130 @@ void DecorationButtonPalette::decodeButtonOverrideColors(const bool active)
     buttonOverrideColors.clear();
     buttonOverrideColorsPresent = false;
 
-    bool overrideButtonTypeValid = false;
-    for (int i = 0; i < InternalSettings::EnumButtonOverrideColorsActiveButtonType::COUNT; i++) {
-        if (static_cast<int>(_buttonType) == i) {
-            overrideButtonTypeValid = true;
-            break;
-        }
-    }
-    if (!overrideButtonTypeValid) {
+    if (static_cast<int>(_buttonType) >= InternalSettings::EnumButtonOverrideColorsActiveButtonType::COUNT) {
         return;
     }
 
-    QByteArray overrideColorsSetting = active ? _decorationSettings->buttonOverrideColorsActive(static_cast<int>(_buttonType)).toUtf8()
-                                              : _decorationSettings->buttonOverrideColorsInactive(static_cast<int>(_buttonType)).toUtf8();
+    const QString overrideColorsSetting = active ? _decorationSettings->buttonOverrideColorsActive(static_cast<int>(_buttonType))
+                                                 : _decorationSettings->buttonOverrideColorsInactive(static_cast<int>(_buttonType));
     if (overrideColorsSetting.isEmpty()) {
         return;
     }
 
-    QJsonDocument document = QJsonDocument::fromJson(overrideColorsSetting);
-
-    QJsonObject buttonStatesObject = document.object();
-    bool overrideColorLoaded = false;
+    const DecodedButtonOverrideColors decodedColors = decodedButtonOverrideColors(overrideColorsSetting);
 
-    for (auto i = buttonStatesObject.begin(); i < buttonStatesObject.end(); i++) {
-        QJsonArray colorArray = i->toArray();
+    for (const DecodedButtonOverrideColor &decodedColor : decodedColors) {
         QColor color;
+        if (decodedColor.colorItemsIndex >= 0) {
+            color = overrideColorItemsIndexToColor(_decorationColors, decodedColor.colorItemsIndex, active);
+            if (!color.isValid())
+                continue;
+        } else {
+            color = QColor::fromRgb(decodedColor.rgb);
+        }
+
+        if (decodedColor.opacity >= 0) {
+            color.setAlphaF(decodedColor.opacity / 100.0f);
+        }
+
+        buttonOverrideColors.insert(decodedColor.state, color);
+    }
+
+    buttonOverrideColorsPresent = !buttonOverrideColors.isEmpty();
+}
+
+DecodedButtonOverrideColors DecorationButtonPalette::decodedButtonOverrideColors(const QString &overrideColorsJson)
+{
+    // the decoded tables are keyed by the JSON string itself, so a settings reload which leaves a string unchanged needs no re-parse
+    static QHash<QString, DecodedButtonOverrideColors> s_decodedCache;
+    static QMutex s_decodedCacheMutex;
+    // bound the cache, as every edit in the configuration UI produces a new string
+    static constexpr int decodedCacheMaxSize = 256;
+
+    QMutexLocker locker(&s_decodedCacheMutex);
+
+    auto cached = s_decodedCache.constFind(overrideColorsJson);
+    if (cached != s_decodedCache.constEnd()) {
+        return cached.value();
+    }
+
+    DecodedButtonOverrideColors decodedColors;
+
+    const QJsonObject buttonStatesObject = QJsonDocument::fromJson(overrideColorsJson.toUtf8()).object();
+
+    for (auto i = buttonStatesObject.begin(); i != buttonStatesObject.end(); i++) {
+        const int overridableButtonColorStatesIndex = overridableButtonColorStatesJsonStrings.indexOf(i.key());
+        if (overridableButtonColorStatesIndex < 0)
+            continue;
+
+        const QJsonArray colorArray = i->toArray();
+        DecodedButtonOverrideColor decodedColor{static_cast<OverridableButtonColorState>(overridableButtonColorStatesIndex), -1, -1, 0};
         int colorOpacity;
-        int overridableButtonColorStatesIndex;
         int overrideColorItemsIndex;
+        int rgbOffset = 0;
+
         switch (colorArray.count()) {
         case 0:
         default:
-            break;
+            continue;
+        case 2:
+            colorOpacity = colorArray[1].toInt(-1);
+            if (colorOpacity < 0 || colorOpacity > 100)
+                continue;
+            decodedColor.opacity = colorOpacity;
+            Q_FALLTHROUGH();
         case 1:
-            overridableButtonColorStatesIndex = overridableButtonColorStatesJsonStrings.indexOf(i.key());
-            if (overridableButtonColorStatesIndex < 0)
-                break;
-
             overrideColorItemsIndex = overrideColorItems.indexOf(colorArray[0].toString());
-            if (overrideColorItemsIndex == 0)
-                break;
-
-            color = overrideColorItemsIndexToColor(_decorationColors, overrideColorItemsIndex, active);
-            if (!color.isValid())
-                break;
-
-            buttonOverrideColors.insert(static_cast<OverridableButtonColorState>(overridableButtonColorStatesIndex), color);
-            overrideColorLoaded = true;
+            if (overrideColorItemsIndex <= 0) // "Custom" or not found
+                continue;
+            decodedColor.colorItemsIndex = overrideColorItemsIndex;
             break;
-        case 2:
-            overridableButtonColorStatesIndex = overridableButtonColorStatesJsonStrings.indexOf(i.key());
-            if (overridableButtonColorStatesIndex < 0)
-                break;
-
-            overrideColorItemsIndex = overrideColorItems.indexOf(colorArray[0].toString());
-            if (overrideColorItemsIndex == 0)
-                break;
-
-            color = overrideColorItemsIndexToColor(_decorationColors, overrideColorItemsIndex, active);
-            if (!color.isValid())
-                break;
+        case 4:
+            colorOpacity = colorArray[0].toInt(-1);
+            if (colorOpacity < 0 || colorOpacity > 100)
+                continue;
+            decodedColor.opacity = colorOpacity;
+            rgbOffset = 1;
+            Q_FALLTHROUGH();
+        case 3: {
+            const int red = colorArray[rgbOffset].toInt();
+            const int green = colorArray[rgbOffset + 1].toInt();
+            const int blue = colorArray[rgbOffset + 2].toInt();
+            if (red < 0 || red > 255 || green < 0 || green > 255 || blue < 0 || blue > 255)
+                continue;
+            decodedColor.rgb = qRgb(red, green, blue);
+            break;
+        }
+        }
 
-            colorOpacity = colorArray[1].toInt(-1);
-            if (colorOpacity >= 0 && colorOpacity <= 100) {
-                color.setAlphaF(colorOpacity / 100.0f);
-            } else {
-                break;
-            }
+        decodedColors.append(decodedColor);
+    }
 
-            buttonOverrideColors.insert(static_cast<OverridableButtonColorState>(overridableButtonColorStatesIndex), color);
-            overrideColorLoaded = true;
-            break;
-        case 3:
-            overridableButtonColorStatesIndex = overridableButtonColorStatesJsonStrings.indexOf(i.key());
-            if (overridableButtonColorStatesIndex < 0)
-                break;
-
-            color.setRed(colorArray[0].toInt());
-            color.setGreen(colorArray[1].toInt());
-            color.setBlue(colorArray[2].toInt());
-            if (!color.isValid())
-                break;
+    if (s_decodedCache.size() >= decodedCacheMaxSize) {
+        s_decodedCache.clear();
+    }
+    s_decodedCache.insert(overrideColorsJson, decodedColors);
 
-            buttonOverrideColors.insert(static_cast<OverridableButtonColorState>(overridableButtonColorStatesIndex), color);
-            overrideColorLoaded = true;
-            break;
-        case 4:
-            overridableButtonColorStatesIndex = overridableButtonColorStatesJsonStrings.indexOf(i.key());
-            if (overridableButtonColorStatesIndex < 0)
-                break;
+    return decodedColors;
+}
 
-            color.setRed(colorArray[1].toInt());
-            color.setGreen(colorArray[2].toInt());
-            color.setBlue(colorArray[3].toInt());
-            if (!color.isValid())
-                break;
+void DecorationButtonPalette::decodeButtonOverrideColorSettings(const InternalSettingsPtr &decorationSettings)
+{
+    if (!decorationSettings) {
+        return;
+    }
 
-            colorOpacity = colorArray[0].toInt(-1);
-            if (colorOpacity >= 0 && colorOpacity <= 100) {
-                color.setAlphaF(colorOpacity / 100.0f);
-            } else {
-                break;
-            }
+    for (int i = 0; i < InternalSettings::EnumButtonOverrideColorsActiveButtonType::COUNT; i++) {
+        const QString activeColors = decorationSettings->buttonOverrideColorsActive(i);
+        if (!activeColors.isEmpty()) {
+            decodedButtonOverrideColors(activeColors);
+        }
 
-            buttonOverrideColors.insert(static_cast<OverridableButtonColorState>(overridableButtonColorStatesIndex), color);
-            overrideColorLoaded = true;
-            break;
+        const QString inactiveColors = decorationSettings->buttonOverrideColorsInactive(i);
+        if (!inactiveColors.isEmpty()) {
+            decodedButtonOverrideColors(inactiveColors);
         }
     }
-
-    buttonOverrideColorsPresent = overrideColorLoaded;
 }
 
 QColor DecorationButtonPalette::overrideColorItemsIndexToColor(const DecorationColors *decorationColors, const int overrideColorItemsIndex, const bool active)
@@ -11,6 +11,7 @@
 #include "decorationcolors.h"
 #include <KColorScheme>
 #include <QColor>
+#include <array>
 #include <memory>
 
 namespace Breeze
@@ -97,6 +98,50 @@ const QStringList overrideColorItems{
     QStringLiteral("WindowShadowInactive"),
 };
 
+//* a single button override colour, decoded from its JSON settings string into a compact form so that palette generation needs no parsing
+struct BREEZECOMMON_EXPORT DecodedButtonOverrideColor {
+    OverridableButtonColorState state;
+    //* index into overrideColorItems, or -1 for a fixed RGB colour stored in rgb
+    qint8 colorItemsIndex;
+    //* opacity percentage to apply, or -1 to keep the colour's own alpha
+    qint8 opacity;
+    QRgb rgb;
+};
+
+using DecodedButtonOverrideColors = QList<DecodedButtonOverrideColor>;
+
+/**
+ *  @brief A colour animation between two colours, precomputed at a fixed number of quantized progress steps when the palette is generated,
+ *         so that animated button colours can be looked up on each frame without any colour-space conversions
+ */
+class BREEZECOMMON_EXPORT ColorTransition
+{
+public:
+    //* number of quantized steps between the start and end colours
+    static constexpr int Steps = 32;
+
+    /**
+     * @brief Generates the lookup table
+     * @param from The colour at progress 0.0
+     * @param to The colour at progress 1.0
+     * @param fadeOutFromWhenToInvalid If \p to is invalid, whether to fade out the alpha of \p from (true), or to return an invalid colour (false)
+     */
+    void generate(const QColor &from, const QColor &to, const bool fadeOutFromWhenToInvalid = true);
+
+    //* returns the interpolated colour for an animation progress between 0.0 and 1.0
+    QColor at(const qreal progress) const
+    {
+        if (!m_valid) {
+            return QColor();
+        }
+        return QColor::fromRgba(m_colors[qBound(0, qRound(progress * Steps), Steps)]);
+    }
+
+private:
+    std::array<QRgb, Steps + 1> m_colors{};
+    bool m_valid = false;
+};
+
 struct BREEZECOMMON_EXPORT DecorationButtonPaletteGroup {
     QColor foregroundPress;
     QColor foregroundHover;
@@ -115,6 +160,26 @@ struct BREEZECOMMON_EXPORT DecorationButtonPaletteGroup {
     QColor outlinePress;
     QColor outlineHover;
     QColor outlineNormal;
+
+    //* precomputed normal to hover colours, used by the button hover animation
+    ColorTransition foregroundHoverTransition;
+    ColorTransition backgroundHoverTransition;
+    ColorTransition outlineHoverTransition;
+};
+
+//* precomputed inactive to active colours for each button state, used by the decoration's active state change animation
+struct BREEZECOMMON_EXPORT DecorationButtonPaletteActiveStateTransitions {
+    ColorTransition foregroundPress;
+    ColorTransition foregroundHover;
+    ColorTransition foregroundNormal;
+
+    ColorTransition backgroundPress;
+    ColorTransition backgroundHover;
+    ColorTransition backgroundNormal;
+
+    ColorTransition outlinePress;
+    ColorTransition outlineHover;
+    ColorTransition outlineNormal;
 };
 
 /**
@@ -125,10 +190,16 @@ class BREEZECOMMON_EXPORT DecorationButtonPalette
 public:
     DecorationButtonPalette(DecorationButtonType buttonType);
 
-    void generate(InternalSettingsPtr decorationSettings,
-                  DecorationColors *decorationColors,
-                  const bool generateOneGroupOnly = false,
-                  const bool oneGroupActiveState = true);
+    /**
+     * @brief Generates the active and/or inactive button colours
+     *        A group is only regenerated if its inputs (the decoration palette colours and the button colour settings it reads) have changed since it was
+     * last generated
+     * @return The number of active/inactive groups which were regenerated
+     */
+    int generate(InternalSettingsPtr decorationSettings,
+                 DecorationColors *decorationColors,
+                 const bool generateOneGroupOnly = false,
+                 const bool oneGroupActiveState = true);
     DecorationButtonPaletteGroup *active() const
     {
         return _active.get();
@@ -137,6 +208,10 @@ public:
     {
         return _inactive.get();
     }
+    const DecorationButtonPaletteActiveStateTransitions *activeStateTransitions() const
+    {
+        return &_activeStateTransitions;
+    }
 
     DecorationButtonType buttonType()
     {
@@ -145,6 +220,15 @@ public:
 
     static QColor overrideColorItemsIndexToColor(const DecorationColors *decorationColors, const int overrideColorItemsIndex, const bool active);
 
+    /**
+     * @brief Returns the decoded form of a ButtonOverrideColors JSON settings string
+     *        Each distinct string is only parsed once; the decoded tables are shared between all palettes in the process
+     */
+    static DecodedButtonOverrideColors decodedButtonOverrideColors(const QString &overrideColorsJson);
+
+    //* Decodes the override colours of every button type in \p decorationSettings, so that subsequent palette generations are lookups only
+    static void decodeButtonOverrideColorSettings(const InternalSettingsPtr &decorationSettings);
+
 private:
     void decodeButtonOverrideColors(const bool active);
     void generateBistateColors(ButtonComponent component,
@@ -168,6 +252,10 @@ private:
                                       const bool active,
                                       const DecorationPaletteGroup *decorationColorGroup);
     void generateButtonOutlinePalette(const bool active);
+    void generateTransitions();
+
+    //* serialises every input read when generating the active or inactive group, for change detection
+    QByteArray generationInputs(const bool active) const;
 
     InternalSettingsPtr _decorationSettings;
     DecorationButtonType _buttonType;
@@ -181,6 +269,12 @@ private:
 
     std::shared_ptr<DecorationButtonPaletteGroup> _active;
     std::shared_ptr<DecorationButtonPaletteGroup> _inactive;
+
+    DecorationButtonPaletteActiveStateTransitions _activeStateTransitions;
+
+    //* inputs of the last generation of each group, empty if never generated
+    QByteArray _generationInputsActive;
+    QByteArray _generationInputsInactive;
 };
 
 }
@@ -5,9 +5,12 @@
  */
 #include "decorationcolors.h"
 #include "colortools.h"
+#include "statistics.h"
+#include "tracing.h"
 #include <KColorUtils>
 #include <KStatefulBrush>
 #include <QDBusConnection>
+#include <QDebug>
 
 namespace Breeze
 {
@@ -63,17 +66,22 @@ void DecorationColors::generateDecorationColors(const QPalette &palette,
                                                 const bool generateOneGroupOnly,
                                                 const bool oneGroupActiveState)
 {
+    KLASSY_TRACE_SCOPE("common", "DecorationColors::generateDecorationColors");
     *m_basePalette = palette;
     if (m_useCachedPalette && !settingsUpdateUuid.isEmpty()) { // m_settingsUpdateUuid must only be accessed/modified when m_useCachedPalette is true
         *static_cast<QByteArray *>(m_settingsUpdateUuid) = settingsUpdateUuid;
     }
 
+    m_lastRecomputedEntryCount = 0;
+
     if (!(generateOneGroupOnly && !oneGroupActiveState)) { // active
         generateDecorationPaletteGroup(palette, decorationSettings, true, titleBarTextActive, titleBarBaseActive, titleBarTextInactive, titleBarBaseInactive);
+        m_lastRecomputedEntryCount++;
     }
 
     if (!(generateOneGroupOnly && oneGroupActiveState)) { // inactive
         generateDecorationPaletteGroup(palette, decorationSettings, false, titleBarTextActive, titleBarBaseActive, titleBarTextInactive, titleBarBaseInactive);
+        m_lastRecomputedEntryCount++;
     }
 
     *m_colorsGenerated = true;
@@ -89,6 +97,7 @@ void DecorationColors::generateDecorationAndButtonColors(const QPalette &palette
                                                          const bool generateOneGroupOnly,
                                                          const bool oneGroupActiveState)
 {
+    KLASSY_TRACE_SCOPE("common", "DecorationColors::generateDecorationAndButtonColors");
     generateDecorationColors(palette,
                              decorationSettings,
                              titleBarTextActive,
@@ -99,9 +108,17 @@ void DecorationColors::generateDecorationAndButtonColors(const QPalette &palette
                              generateOneGroupOnly,
                              oneGroupActiveState);
 
+    // each button palette only regenerates the groups whose inputs have changed, so e.g. an accent colour change does not regenerate buttons which do not
+    // use the accent colour
     for (auto i = m_buttonPalettes->begin(); i != m_buttonPalettes->end(); i++) {
-        i->second.generate(decorationSettings, this, generateOneGroupOnly, oneGroupActiveState);
+        m_lastRecomputedEntryCount += i->second.generate(decorationSettings, this, generateOneGroupOnly, oneGroupActiveState);
     }
+    Statistics::self()->increment("paletteRegenerations");
+    Statistics::self()->increment("paletteGroupsRegenerated", m_lastRecomputedEntryCount);
+
+#if KLASSY_DECORATION_DEBUG_MODE
+    qDebug() << "klassy: DecorationColors regenerated" << m_lastRecomputedEntryCount << "palette groups, cached:" << m_useCachedPalette;
+#endif
 }
 
 void DecorationColors::generateDecorationPaletteGroup(const QPalette &palette,
@@ -112,6 +129,7 @@ void DecorationColors::generateDecorationPaletteGroup(const QPalette &palette,
                                                       QColor &titleBarTextInactive,
                                                       QColor &titleBarBaseInactive)
 {
+    KLASSY_TRACE_SCOPE("common", "DecorationColors::generateDecorationPaletteGroup");
     std::unique_ptr<DecorationPaletteGroup> *decorationPaletteGroup = active ? m_decorationPaletteGroupActive : m_decorationPaletteGroupInactive;
 
     (*decorationPaletteGroup)->titleBarBase = active ? titleBarBaseActive : titleBarBaseInactive;
@@ -95,6 +95,15 @@ public:
         return m_basePalette;
     }
 
+    /**
+     * @brief Debug counter of the number of palette groups recomputed by the last generateDecorationColors() or generateDecorationAndButtonColors() call
+     *        Each active or inactive decoration palette group and each active or inactive button palette group counts as one entry
+     */
+    int lastRecomputedEntryCount() const
+    {
+        return m_lastRecomputedEntryCount;
+    }
+
     QByteArray settingsUpdateUuid()
     {
         if (m_useCachedPalette) {
@@ -175,6 +184,7 @@ private:
 
     bool m_useCachedPalette;
     bool m_forAppStyle;
+    int m_lastRecomputedEntryCount = 0;
 
     //* pointers to whether to return the static cached palette data or non-cached class member data
     QPalette *m_basePalette;
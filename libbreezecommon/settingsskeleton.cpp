@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "settingsskeleton.h"
+
+namespace Breeze
+{
+
+thread_local bool SettingsSkeleton::s_detached = false;
+
+//______________________________________________________________
+SettingsSkeleton::SettingsSkeleton(const QString &configName, QObject *parent)
+    : KConfigSkeleton(sharedConfig(configName), parent)
+{
+}
+
+//______________________________________________________________
+KSharedConfig::Ptr SettingsSkeleton::sharedConfig(const QString &configName)
+{
+    // an empty file name with SimpleConfig gives a configuration which is never read from or written to disk
+    return s_detached ? KSharedConfig::openConfig(QString(), KConfig::SimpleConfig) : KSharedConfig::openConfig(configName);
+}
+
+//______________________________________________________________
+SettingsSkeleton::DetachedScope::DetachedScope()
+    : m_previous(s_detached)
+{
+    s_detached = true;
+}
+
+//______________________________________________________________
+SettingsSkeleton::DetachedScope::~DetachedScope()
+{
+    s_detached = m_previous;
+}
+
+}
@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include "breezecommon_export.h"
+
+#include <KConfigSkeleton>
+
+namespace Breeze
+{
+
+/**
+ * @brief Base class of the generated InternalSettings.
+ *        Settings are normally bound to klassyrc, but settings constructed within a DetachedScope are bound to an in-memory configuration instead,
+ *        so that settings whose values are set directly, such as those restored from the SettingsSnapshot, do not open and parse klassyrc.
+ */
+class BREEZECOMMON_EXPORT SettingsSkeleton : public KConfigSkeleton
+{
+public:
+    //* called by the generated InternalSettings constructor with its configuration file name
+    explicit SettingsSkeleton(const QString &configName, QObject *parent = nullptr);
+
+    //* while in scope, settings constructed on this thread are not bound to a configuration file
+    class DetachedScope
+    {
+    public:
+        DetachedScope();
+        ~DetachedScope();
+
+    private:
+        bool m_previous;
+
+        Q_DISABLE_COPY(DetachedScope)
+    };
+
+private:
+    //* the configuration the settings are bound to
+    static KSharedConfig::Ptr sharedConfig(const QString &configName);
+
+    //* whether settings constructed on this thread should be detached
+    static thread_local bool s_detached;
+};
+
+}
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "settingssnapshot.h"
+#include "decorationexceptionlist.h"
+#include "presetsmodel.h"
+#include "settingsskeleton.h"
+#include "statistics.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVariantList>
+
+namespace Breeze
+{
+
+//* serialize the values of all the items of the given settings, in item order
+static QByteArray settingsValues(InternalSettings *settings)
+{
+    QVariantList values;
+    const KConfigSkeletonItem::List items = settings->items();
+    values.reserve(items.count());
+    for (const KConfigSkeletonItem *item : items) {
+        values.append(item->property());
+    }
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << values;
+    return data;
+}
+
+//* create settings from values written by settingsValues, returns a null pointer if they do not match the schema
+static InternalSettingsPtr settingsFromValues(const QVariantList &values, bool noCacheException)
+{
+    // the values are set directly, so the settings do not need to be bound to klassyrc
+    SettingsSkeleton::DetachedScope detached;
+    InternalSettingsPtr settings(new InternalSettings());
+    const KConfigSkeletonItem::List items = settings->items();
+    if (items.count() != values.count()) {
+        return InternalSettingsPtr();
+    }
+
+    for (int i = 0; i < items.count(); ++i) {
+        items.at(i)->setProperty(values.at(i));
+    }
+
+    if (noCacheException) {
+        settings->setProperty("noCacheException", true);
+    }
+    return settings;
+}
+
+//______________________________________________________________
+QString SettingsSnapshot::filePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QStringLiteral("/klassy/settingssnapshot");
+}
+
+//______________________________________________________________
+QByteArray SettingsSnapshot::schemaHash()
+{
+    return QByteArrayLiteral(KLASSY_SETTINGS_SCHEMA_HASH);
+}
+
+//______________________________________________________________
+QByteArray SettingsSnapshot::configurationStamp(const QStringList &configFiles)
+{
+    const QString configPath = QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation);
+
+    QByteArray stamp;
+    QDataStream stream(&stamp, QIODevice::WriteOnly);
+    for (const QString &configFile : configFiles) {
+        const QFileInfo info(configPath + QLatin1Char('/') + configFile);
+        stream << info.lastModified().toMSecsSinceEpoch() << info.size();
+    }
+    return stamp;
+}
+
+//______________________________________________________________
+QByteArray SettingsSnapshot::sourceStamp()
+{
+    return configurationStamp({QStringLiteral("klassy/klassyrc"), QStringLiteral("klassy/windecopresetsrc")});
+}
+
+//______________________________________________________________
+bool SettingsSnapshot::write()
+{
+    // stamp before reading, so that a configuration change made while writing leaves the snapshot stale rather than wrong
+    const QByteArray stamp = sourceStamp();
+
+    KSharedConfig::Ptr config = KSharedConfig::openConfig(QStringLiteral("klassy/klassyrc"));
+    config->reparseConfiguration();
+
+    InternalSettings defaultSettings;
+    defaultSettings.load();
+
+    DecorationExceptionList exceptionList;
+    exceptionList.readConfig(config);
+    InternalSettingsList exceptions = exceptionList.getDefault();
+    exceptions.append(exceptionList.get());
+
+    // only exceptions matching on the program name can apply to an application
+    InternalSettingsList programExceptions;
+    for (const InternalSettingsPtr &exception : std::as_const(exceptions)) {
+        if (exception->enabled() && !exception->exceptionProgramNamePattern().isEmpty()) {
+            programExceptions.append(exception);
+        }
+    }
+
+    const QString path = filePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    // the table of exceptions comes first, followed by the serialized values of the defaults and of each exception,
+    // so that the style can skip to the values it needs without deserializing the others
+    QList<QByteArray> valuesList{settingsValues(&defaultSettings)};
+    KSharedConfig::Ptr presetsConfig;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << s_magic << s_formatVersion << schemaHash() << stamp;
+    stream << quint32(valuesList.first().size()) << quint32(programExceptions.count());
+    for (const InternalSettingsPtr &exception : std::as_const(programExceptions)) {
+        // presets are resolved here so that the style does not need to read windecopresetsrc
+        // a preset or an opaque titlebar can alter shadows and colours, so these must not be cached
+        bool noCacheException = exception->opaqueTitleBar();
+        if (!exception->exceptionPreset().isEmpty()) {
+            if (!presetsConfig) {
+                presetsConfig = KSharedConfig::openConfig(QStringLiteral("klassy/windecopresetsrc"));
+            }
+            PresetsModel::loadPreset(exception.data(), presetsConfig.data(), exception->exceptionPreset());
+            noCacheException = true;
+        }
+
+        valuesList.append(settingsValues(exception.data()));
+        stream << exception->exceptionProgramNamePattern() << noCacheException << quint32(valuesList.last().size());
+    }
+
+    for (const QByteArray &values : std::as_const(valuesList)) {
+        stream.writeRawData(values.constData(), values.size());
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+//______________________________________________________________
+InternalSettingsPtr SettingsSnapshot::load(const QString &programName)
+{
+    QFile file(filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        Statistics::self()->recordCacheMiss("settingsSnapshot");
+        return InternalSettingsPtr();
+    }
+
+    const qint64 size = file.size();
+    const uchar *data = file.map(0, size);
+    if (!data) {
+        Statistics::self()->recordCacheMiss("settingsSnapshot");
+        return InternalSettingsPtr();
+    }
+
+    // read in place from the mapping rather than copying the file
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data), size);
+    QDataStream stream(bytes);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    QByteArray hash;
+    QByteArray stamp;
+    stream >> magic >> formatVersion;
+    if (magic != s_magic || formatVersion != s_formatVersion) {
+        Statistics::self()->recordCacheMiss("settingsSnapshot");
+        return InternalSettingsPtr();
+    }
+
+    stream >> hash >> stamp;
+    if (stream.status() != QDataStream::Ok || hash != schemaHash() || stamp != sourceStamp()) {
+        Statistics::self()->recordCacheMiss("settingsSnapshot");
+        return InternalSettingsPtr();
+    }
+
+    quint32 defaultValuesSize = 0;
+    quint32 exceptionCount = 0;
+    stream >> defaultValuesSize >> exceptionCount;
+
+    // find the values which apply to the program in the table, and the offset of those values from the end of the table
+    qint64 valuesOffset = 0;
+    qint64 valuesSize = defaultValuesSize;
+    qint64 precedingValuesSize = defaultValuesSize;
+    bool matched = false;
+    bool noCacheException = false;
+    for (quint32 i = 0; i < exceptionCount && stream.status() == QDataStream::Ok; ++i) {
+        QString pattern;
+        bool exceptionNoCache = false;
+        quint32 exceptionValuesSize = 0;
+        stream >> pattern >> exceptionNoCache >> exceptionValuesSize;
+
+        if (!matched && QRegularExpression(pattern).match(programName).hasMatch()) {
+            matched = true;
+            valuesOffset = precedingValuesSize;
+            valuesSize = exceptionValuesSize;
+            noCacheException = exceptionNoCache;
+        }
+        precedingValuesSize += exceptionValuesSize;
+    }
+
+    InternalSettingsPtr settings;
+    if (stream.status() == QDataStream::Ok && stream.skipRawData(int(valuesOffset)) == valuesOffset) {
+        const qint64 valuesPosition = stream.device()->pos();
+        if (valuesPosition + valuesSize <= size) {
+            // only the selected values are deserialized, still in place from the mapping
+            const QByteArray valuesBytes = QByteArray::fromRawData(bytes.constData() + valuesPosition, valuesSize);
+            QDataStream valuesStream(valuesBytes);
+            valuesStream.setVersion(QDataStream::Qt_6_0);
+            QVariantList values;
+            valuesStream >> values;
+            if (valuesStream.status() == QDataStream::Ok) {
+                settings = settingsFromValues(values, noCacheException);
+            }
+        }
+    }
+
+    if (settings) {
+        Statistics::self()->recordCacheHit("settingsSnapshot");
+    } else {
+        Statistics::self()->recordCacheMiss("settingsSnapshot");
+    }
+    return settings;
+}
+
+}
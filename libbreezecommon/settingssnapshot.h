@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include "breezecommon_export.h"
+
+#include "breeze.h"
+#include "breezesettings.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+namespace Breeze
+{
+
+/**
+ * @brief Versioned binary snapshot of the resolved decoration settings and of the per-application exception table, as needed by the application style.
+ *        It is written by the settings tools whenever the configuration is saved, and memory-mapped by the style so that each application can
+ *        avoid parsing klassyrc, its exception groups and windecopresetsrc through KConfig.
+ *        The values of the defaults and of each exception are stored separately after a table of the exception patterns, so that only the values
+ *        which apply to the application are deserialized.
+ *        A snapshot is only used when its format, the settings schema and the modification stamps of its source files all match; otherwise the
+ *        caller falls back to KConfig.
+ */
+class BREEZECOMMON_EXPORT SettingsSnapshot
+{
+public:
+    //* location of the snapshot file
+    static QString filePath();
+
+    //* resolve the current configuration and write it atomically to filePath(), returns false on failure
+    static bool write();
+
+    /**
+     * @brief Load the settings which apply to the given program from the snapshot
+     * @param programName The application name to match against the exception program name patterns
+     * @return The resolved settings, or a null pointer if the snapshot is missing, unreadable or stale
+     */
+    static InternalSettingsPtr load(const QString &programName);
+
+    //* modification times and sizes of the given files, relative to the user's configuration directory, to detect when they have changed
+    static QByteArray configurationStamp(const QStringList &configFiles);
+
+private:
+    //* identifies the snapshot file
+    static constexpr quint32 s_magic = 0x4b4c5353; // "KLSS"
+
+    //* increment whenever the layout of the snapshot file changes
+    static constexpr quint32 s_formatVersion = 2;
+
+    //* hash of the settings schema, computed from breezesettingsdata.kcfg at build time, so that a snapshot from a different version of Klassy is ignored
+    static QByteArray schemaHash();
+
+    //* modification times and sizes of the configuration files the snapshot is resolved from
+    static QByteArray sourceStamp();
+};
+
+}
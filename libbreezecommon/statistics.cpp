@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "statistics.h"
+
+#include <QDBusConnection>
+#include <QJsonDocument>
+#include <QMutexLocker>
+
+namespace Breeze
+{
+
+Statistics *Statistics::s_self = nullptr;
+
+//________________________________________________________________
+Statistics *Statistics::self()
+{
+    // deliberately never deleted, so that counters can still be recorded during plugin teardown
+    if (!s_self) {
+        s_self = new Statistics();
+    }
+
+    return s_self;
+}
+
+//________________________________________________________________
+void Statistics::recordCacheHit(const char *cache)
+{
+    QMutexLocker locker(&m_mutex);
+    entry(m_caches, cache).hits++;
+}
+
+//________________________________________________________________
+void Statistics::recordCacheMiss(const char *cache)
+{
+    QMutexLocker locker(&m_mutex);
+    entry(m_caches, cache).misses++;
+}
+
+//________________________________________________________________
+void Statistics::setCacheBytes(const char *cache, qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    entry(m_caches, cache).bytes = bytes;
+}
+
+//________________________________________________________________
+void Statistics::increment(const char *counter, qint64 amount)
+{
+    QMutexLocker locker(&m_mutex);
+    entry(m_counters, counter) += amount;
+}
+
+//________________________________________________________________
+void Statistics::setGauge(const char *gauge, qint64 value)
+{
+    QMutexLocker locker(&m_mutex);
+    entry(m_gauges, gauge) = value;
+}
+
+//________________________________________________________________
+void Statistics::recordDuration(const char *timing, qint64 nsecs)
+{
+    QMutexLocker locker(&m_mutex);
+    DurationCounters &duration = entry(m_durations, timing);
+    duration.count++;
+    duration.totalNsecs += nsecs;
+    duration.maxNsecs = qMax(duration.maxNsecs, nsecs);
+}
+
+//________________________________________________________________
+bool Statistics::registerOnSessionBus()
+{
+    if (m_registeredOnSessionBus) {
+        return true;
+    }
+
+    m_registeredOnSessionBus = QDBusConnection::sessionBus().registerObject(QString::fromLatin1(dBusPath), this, QDBusConnection::ExportScriptableSlots);
+    return m_registeredOnSessionBus;
+}
+
+//________________________________________________________________
+QJsonObject Statistics::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject caches;
+    for (auto it = m_caches.cbegin(); it != m_caches.cend(); ++it) {
+        QJsonObject cache;
+        cache[QStringLiteral("hits")] = it->hits;
+        cache[QStringLiteral("misses")] = it->misses;
+        const qint64 lookups = it->hits + it->misses;
+        cache[QStringLiteral("hitRatio")] = lookups ? qreal(it->hits) / lookups : 0.0;
+        if (it->bytes >= 0) {
+            cache[QStringLiteral("bytes")] = it->bytes;
+        }
+        caches[QString::fromLatin1(it.key())] = cache;
+    }
+
+    QJsonObject counters;
+    for (auto it = m_counters.cbegin(); it != m_counters.cend(); ++it) {
+        counters[QString::fromLatin1(it.key())] = it.value();
+    }
+
+    QJsonObject gauges;
+    for (auto it = m_gauges.cbegin(); it != m_gauges.cend(); ++it) {
+        gauges[QString::fromLatin1(it.key())] = it.value();
+    }
+
+    QJsonObject durations;
+    for (auto it = m_durations.cbegin(); it != m_durations.cend(); ++it) {
+        QJsonObject duration;
+        duration[QStringLiteral("count")] = it->count;
+        duration[QStringLiteral("totalMs")] = it->totalNsecs / 1000000.0;
+        duration[QStringLiteral("meanMs")] = it->count ? it->totalNsecs / 1000000.0 / it->count : 0.0;
+        duration[QStringLiteral("maxMs")] = it->maxNsecs / 1000000.0;
+        durations[QString::fromLatin1(it.key())] = duration;
+    }
+
+    QJsonObject result;
+    result[QStringLiteral("caches")] = caches;
+    result[QStringLiteral("counters")] = counters;
+    result[QStringLiteral("gauges")] = gauges;
+    result[QStringLiteral("durations")] = durations;
+    return result;
+}
+
+//________________________________________________________________
+QString Statistics::statistics() const
+{
+    return QString::fromUtf8(QJsonDocument(toJson()).toJson(QJsonDocument::Compact));
+}
+
+//________________________________________________________________
+void Statistics::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+
+    // gauges report current state rather than accumulating, so are kept
+    m_caches.clear();
+    m_counters.clear();
+    m_durations.clear();
+}
+
+}
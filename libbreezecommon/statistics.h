@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+#include "breezecommon_export.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+
+namespace Breeze
+{
+
+/**
+ * @brief Process-wide registry of runtime counters for Klassy's caches, palette generation, shadows, animations and reconfiguration.
+ *        In KWin it is exported on the session bus at /KlassyDecoration (org.kde.Klassy.Statistics), and read by "klassy-settings --stats".
+ *        Names are copied the first time they are recorded, and later recordings under the same name do not allocate.
+ */
+class BREEZECOMMON_EXPORT Statistics : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.Klassy.Statistics")
+
+public:
+    static constexpr const char *dBusService = "org.kde.KWin";
+    static constexpr const char *dBusPath = "/KlassyDecoration";
+    static constexpr const char *dBusInterface = "org.kde.Klassy.Statistics";
+
+    //* singleton
+    static Statistics *self();
+
+    //*@name caches
+    //@{
+    void recordCacheHit(const char *cache);
+    void recordCacheMiss(const char *cache);
+    void setCacheBytes(const char *cache, qint64 bytes);
+    //@}
+
+    //* adds to a monotonically increasing counter, e.g. the number of shadow renders
+    void increment(const char *counter, qint64 amount = 1);
+
+    //* sets a counter reporting a current value, e.g. the number of running animations
+    void setGauge(const char *gauge, qint64 value);
+
+    //* records one occurrence of a timed operation, e.g. a reconfigure pass
+    void recordDuration(const char *timing, qint64 nsecs);
+
+    //* exports the statistics on the session bus; returns false if the path is already taken
+    bool registerOnSessionBus();
+
+    QJsonObject toJson() const;
+
+public Q_SLOTS:
+    //* the statistics as a JSON object string
+    Q_SCRIPTABLE QString statistics() const;
+
+    Q_SCRIPTABLE void resetStatistics();
+
+private:
+    Statistics() = default;
+
+    struct CacheCounters {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 bytes = -1; // not reported when never set
+    };
+
+    struct DurationCounters {
+        qint64 count = 0;
+        qint64 totalNsecs = 0;
+        qint64 maxNsecs = 0;
+    };
+
+    /**
+     * @brief The entry for the given name, inserted if needed.
+     *        Existing entries are found through a raw data wrapper so that recording does not allocate, but new entries are keyed by a copy
+     *        of the name, as the callers' literals live in plugins which can be unloaded while the statistics remain.
+     */
+    template<typename T>
+    static T &entry(QHash<QByteArray, T> &hash, const char *name)
+    {
+        const auto iter = hash.find(QByteArray::fromRawData(name, qstrlen(name)));
+        if (iter != hash.end()) {
+            return iter.value();
+        }
+        return hash[QByteArray(name)];
+    }
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, CacheCounters> m_caches;
+    QHash<QByteArray, qint64> m_counters;
+    QHash<QByteArray, qint64> m_gauges;
+    QHash<QByteArray, DurationCounters> m_durations;
+    bool m_registeredOnSessionBus = false;
+
+    //* singleton
+    static Statistics *s_self;
+};
+
+}
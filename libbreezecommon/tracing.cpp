@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#include "tracing.h"
+
+#if KLASSY_TRACING
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <atomic>
+#include <chrono>
+
+namespace Breeze
+{
+
+namespace
+{
+
+/**
+ * @brief Buffers trace events and appends them to the trace file in batches.
+ *        The file is a JSON array of events; the closing bracket is written on destruction, but is optional for the trace viewers,
+ *        so a trace from a process which crashed can still be loaded.
+ */
+class TraceWriter
+{
+public:
+    TraceWriter()
+    {
+        QByteArray path = qgetenv("KLASSY_TRACE");
+        if (path.isEmpty()) {
+            return;
+        }
+        path.replace("%p", QByteArray::number(QCoreApplication::applicationPid()));
+
+        m_file.setFileName(QFile::decodeName(path));
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning("Klassy: could not open trace file %s", path.constData());
+            return;
+        }
+        m_file.write("[\n");
+        m_enabled = true;
+    }
+
+    ~TraceWriter()
+    {
+        if (!m_enabled) {
+            return;
+        }
+        QMutexLocker locker(&m_mutex);
+        m_buffer.append("\n]\n");
+        flush();
+    }
+
+    bool enabled() const
+    {
+        return m_enabled;
+    }
+
+    void append(const QByteArray &event)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_hasEvents) {
+            m_buffer.append(",\n");
+        }
+        m_hasEvents = true;
+        m_buffer.append(event);
+
+        if (m_buffer.size() >= s_flushSize) {
+            flush();
+        }
+    }
+
+private:
+    void flush()
+    {
+        m_file.write(m_buffer);
+        m_file.flush();
+        m_buffer.clear();
+    }
+
+    //* write out in batches so that tracing does not itself add a file write to every traced call
+    static constexpr qsizetype s_flushSize = 64 * 1024;
+
+    bool m_enabled = false;
+    bool m_hasEvents = false;
+    QFile m_file;
+    QByteArray m_buffer;
+    QMutex m_mutex;
+};
+
+TraceWriter &traceWriter()
+{
+    static TraceWriter writer;
+    return writer;
+}
+
+//* small sequential thread IDs are easier to read in the trace viewers than native thread handles
+int traceThreadId()
+{
+    static std::atomic<int> nextThreadId = 1;
+    thread_local const int threadId = nextThreadId++;
+    return threadId;
+}
+
+}
+
+//________________________________________________________________
+bool Tracer::enabled()
+{
+    static const bool enabled = traceWriter().enabled();
+    return enabled;
+}
+
+//________________________________________________________________
+qint64 Tracer::now()
+{
+    // steady_clock is CLOCK_MONOTONIC on Linux, so traces from KWin and applications line up when loaded together
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//________________________________________________________________
+void Tracer::addCompleteEvent(const char *category, const char *name, qint64 startNs, qint64 endNs, const char *argName, int argValue)
+{
+    if (!enabled()) {
+        return;
+    }
+
+    static const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    // trace event timestamps are in microseconds
+    QByteArray event;
+    event.reserve(160);
+    event.append("{\"name\":\"").append(name);
+    event.append("\",\"cat\":\"").append(category);
+    event.append("\",\"ph\":\"X\",\"ts\":").append(QByteArray::number(startNs / 1000.0, 'f', 3));
+    event.append(",\"dur\":").append(QByteArray::number((endNs - startNs) / 1000.0, 'f', 3));
+    event.append(",\"pid\":").append(pid);
+    event.append(",\"tid\":").append(QByteArray::number(traceThreadId()));
+    if (argName) {
+        event.append(",\"args\":{\"").append(argName).append("\":").append(QByteArray::number(argValue)).append('}');
+    }
+    event.append('}');
+
+    traceWriter().append(event);
+}
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Paul A McAuley <kde@paulmcauley.com>
+ *
+ * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+ */
+
+#pragma once
+
+//* build with -DKLASSY_TRACING=ON to compile in the trace markers; otherwise they compile to nothing
+#ifndef KLASSY_TRACING
+#define KLASSY_TRACING 0
+#endif
+
+#if KLASSY_TRACING
+
+#include "breezecommon_export.h"
+
+#include <QtGlobal>
+
+namespace Breeze
+{
+
+/**
+ * @brief Writes trace events in the Chrome trace event format, readable by chrome://tracing and ui.perfetto.dev
+ *        Tracing is active only when the KLASSY_TRACE environment variable is set to the path of the trace file to write.
+ *        A "%p" in the path is replaced by the process ID, so that KWin and each application using the style can write their own trace.
+ */
+class BREEZECOMMON_EXPORT Tracer
+{
+public:
+    //* whether KLASSY_TRACE is set for this process
+    static bool enabled();
+
+    //* monotonic timestamp in nanoseconds, comparable between processes
+    static qint64 now();
+
+    //* records a complete ("X") event; argName may be null if there is no argument
+    static void addCompleteEvent(const char *category, const char *name, qint64 startNs, qint64 endNs, const char *argName = nullptr, int argValue = 0);
+};
+
+//* records the lifetime of the scope as a complete event
+class TraceScope
+{
+public:
+    TraceScope(const char *category, const char *name, const char *argName = nullptr, int argValue = 0)
+        : m_category(category)
+        , m_name(name)
+        , m_argName(argName)
+        , m_argValue(argValue)
+        , m_start(Tracer::enabled() ? Tracer::now() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_start >= 0) {
+            Tracer::addCompleteEvent(m_category, m_name, m_start, Tracer::now(), m_argName, m_argValue);
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *m_category;
+    const char *m_name;
+    const char *m_argName;
+    int m_argValue;
+    qint64 m_start;
+};
+
+}
+
+#define KLASSY_TRACE_CONCAT_INNER(a, b) a##b
+#define KLASSY_TRACE_CONCAT(a, b) KLASSY_TRACE_CONCAT_INNER(a, b)
+
+//* traces the enclosing scope; category and name must be string literals
+#define KLASSY_TRACE_SCOPE(category, name) const Breeze::TraceScope KLASSY_TRACE_CONCAT(klassyTraceScope_, __LINE__)(category, name)
+
+//* as KLASSY_TRACE_SCOPE, also recording an integer argument such as a style element
+#define KLASSY_TRACE_SCOPE_ARG(category, name, argName, argValue)                                                                                              \
+    const Breeze::TraceScope KLASSY_TRACE_CONCAT(klassyTraceScope_, __LINE__)(category, name, argName, int(argValue))
+
+#else
+
+#define KLASSY_TRACE_SCOPE(category, name)
+#define KLASSY_TRACE_SCOPE_ARG(category, name, argName, argValue)
+
+#endif